@@ -16,6 +16,7 @@
 #define ERR_EMPTY_OPTION "No option specified for %s"
 #define ERR_UNKNOWN_VALUE "Unknown value: %s"
 #define ERR_UNKNOWN_OPTION "Unknown option: %s"
+#define ERR_UNSUPPORTED_VALUE "Not supported in this build: %s"
 
 #define HASHF_PREFIX "hashf="
 #define HASHF_MURMUR HASHF_PREFIX "murmur"
@@ -25,6 +26,14 @@
 #define ITERN_ON ITERN_PREFIX "on"
 #define ITERN_OFF ITERN_PREFIX "off"
 
+#define BCOPT_PREFIX "bcopt="
+#define BCOPT_ON BCOPT_PREFIX "on"
+#define BCOPT_OFF BCOPT_PREFIX "off"
+
+#define SUPERINS_PREFIX "superins="
+#define SUPERINS_ON SUPERINS_PREFIX "on"
+#define SUPERINS_OFF SUPERINS_PREFIX "off"
+
 static int opt_is_prefixed(const char *s, const char *prefix)
 {
 	lua_assert(s != NULL);
@@ -60,6 +69,38 @@ static enum opt_parse_status opt_set_itern(const char *kv,
 	return OPT_PARSE_ERROR;
 }
 
+static enum opt_parse_status opt_set_bcopt(const char *kv,
+					   struct luae_Options *opt)
+{
+	if (strcmp(kv, BCOPT_ON) == 0) {
+		opt->enablebcopt = 1;
+		return OPT_PARSE_OK;
+	} else if (strcmp(kv, BCOPT_OFF) == 0) {
+		opt->enablebcopt = 0;
+		return OPT_PARSE_OK;
+	}
+
+	return OPT_PARSE_ERROR;
+}
+
+static enum opt_parse_status opt_set_superins(const char *kv,
+					      struct luae_Options *opt)
+{
+	if (strcmp(kv, SUPERINS_ON) == 0) {
+#ifdef UJIT_SUPERINS
+		opt->enablesuperins = 1;
+		return OPT_PARSE_OK;
+#else
+		return OPT_PARSE_UNSUPPORTED;
+#endif
+	} else if (strcmp(kv, SUPERINS_OFF) == 0) {
+		opt->enablesuperins = 0;
+		return OPT_PARSE_OK;
+	}
+
+	return OPT_PARSE_ERROR;
+}
+
 typedef enum opt_parse_status (*opt_setter_func)(const char *,
 						 struct luae_Options *);
 
@@ -70,7 +111,9 @@ struct opt_setter_map {
 
 static const struct opt_setter_map opt_setters[] = {
 	{HASHF_PREFIX, opt_set_hashf},
-	{ITERN_PREFIX, opt_set_itern}};
+	{ITERN_PREFIX, opt_set_itern},
+	{BCOPT_PREFIX, opt_set_bcopt},
+	{SUPERINS_PREFIX, opt_set_superins}};
 
 enum opt_parse_status cli_opt_parse_kv(const char *kv, struct luae_Options *opt,
 				       char *buffer, size_t n)
@@ -100,9 +143,14 @@ enum opt_parse_status cli_opt_parse_kv(const char *kv, struct luae_Options *opt,
 		return OPT_PARSE_ERROR;
 	}
 
-	if (opt_setter(kv, opt) == OPT_PARSE_OK)
+	switch (opt_setter(kv, opt)) {
+	case OPT_PARSE_OK:
 		return OPT_PARSE_OK;
-
-	snprintf(buffer, n, ERR_UNKNOWN_VALUE, kv);
-	return OPT_PARSE_ERROR;
+	case OPT_PARSE_UNSUPPORTED:
+		snprintf(buffer, n, ERR_UNSUPPORTED_VALUE, kv);
+		return OPT_PARSE_ERROR;
+	default:
+		snprintf(buffer, n, ERR_UNKNOWN_VALUE, kv);
+		return OPT_PARSE_ERROR;
+	}
 }
@@ -11,7 +11,8 @@
 
 struct luae_Options;
 
-enum opt_parse_status { OPT_PARSE_OK, OPT_PARSE_ERROR };
+/* OPT_PARSE_UNSUPPORTED is used by option setters only. */
+enum opt_parse_status { OPT_PARSE_OK, OPT_PARSE_ERROR, OPT_PARSE_UNSUPPORTED };
 
 /*
  * Parses a single key-value argument. In case of success, sets a corresponding
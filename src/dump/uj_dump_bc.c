@@ -133,7 +133,7 @@ void uj_dump_bc_ins(FILE *out, const GCproto *pt, const BCIns *ins,
 			sprintf(hint, "%d",
 				(int)(nvalue - ((int64_t)0x1 << 52)));
 		else
-			uj_cstr_fromnum(hint, nvalue);
+			hint[uj_cstr_fromnum(hint, nvalue)] = '\0';
 		break;
 	}
 	case BCMfunc: {
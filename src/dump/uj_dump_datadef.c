@@ -65,6 +65,13 @@ LJ_DATADEF const char *const dump_trace_errors[] = {
 	/* sentinel */
 	NULL};
 
+LJ_DATADEF const char *const dump_trace_error_names[] = {
+#define TREDEF(name, msg) (#name),
+#include "jit/lj_traceerr.h"
+#undef TREDEF
+	/* sentinel */
+	NULL};
+
 /* Names of link types. ORDER LJ_TRLINK */
 LJ_DATADEF const char *const dump_trace_lt_names[] = {
 	"none",		"root",		  "loop",	 "tail-recursion",
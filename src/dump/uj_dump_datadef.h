@@ -25,6 +25,8 @@ LJ_DATA const char *const dump_ir_fpm_names[];
 
 /* Tracing error descriptions. */
 LJ_DATA const char *const dump_trace_errors[];
+/* Tracing error names. */
+LJ_DATA const char *const dump_trace_error_names[];
 /* Trace link type names. */
 LJ_DATA const char *const dump_trace_lt_names[];
 
@@ -0,0 +1,427 @@
+/*
+ * Dumper of live heap snapshots.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ *
+ * The snapshot lists all collectable objects of the VM together with
+ * references between them, so that it can be analyzed offline for answering
+ * "what is alive and who holds it" (see tools/ujit-parse-heapdump). A full GC
+ * cycle is run before dumping, so only objects reachable from the GC roots are
+ * reported. References are the same as the ones followed by the GC, except
+ * for weak references which are omitted as they do not retain objects.
+ *
+ * Dump format:
+ *
+ * heapdump       := prologue roots object* epilogue
+ * prologue       := 'u' 'j' 'h' version reserved
+ * version        := <BYTE>
+ * reserved       := <BYTE> <BYTE> <BYTE>
+ * roots          := nedges edge*
+ * object         := type addr size nedges edge* name
+ * type           := <BYTE>
+ * addr           := <ULEB128>
+ * size           := <ULEB128>
+ * nedges         := <ULEB128>
+ * edge           := <ULEB128>
+ * name           := <ULEB128> <BYTE>*
+ * epilogue       := 0xff
+ *
+ * type is the bitwise negation of the object's LJ_T* tag (e.g. 4 for strings,
+ * 11 for tables). edge is the address of a referenced object. Objects owned
+ * by the data state (if any) are referenced, but not listed. name is a
+ * length-prefixed human-readable description of the object: a prefix of the
+ * payload for strings, location of the definition for functions and
+ * prototypes, an empty string otherwise.
+ *
+ * Addresses are the same as reported by memprof, so that allocation sites
+ * can be attributed to live objects if memprof was running when the objects
+ * were allocated.
+ */
+
+#include "lj_obj.h"
+#include "lj_gc.h"
+#include "lj_frame.h"
+#include "lj_tab.h"
+#include "uj_func.h"
+#include "uj_meta.h"
+#include "uj_proto.h"
+#include "uj_str.h"
+#include "uj_udata.h"
+#include "utils/leb128.h"
+#if LJ_HASJIT
+#include "uj_dispatch.h"
+#include "jit/lj_jit.h"
+#include "jit/lj_trace.h"
+#include "jit/lj_ir.h"
+#endif /* LJ_HASJIT */
+#if LJ_HASFFI
+#include "ffi/lj_ctype.h"
+#endif /* LJ_HASFFI */
+
+#include "dump/uj_dump_iface.h"
+
+#define HEAPDUMP_VERSION 1
+#define HEAPDUMP_EPILOGUE 0xff
+
+/* Strings are described with the first HEAPDUMP_STRNAME_MAX bytes. */
+#define HEAPDUMP_STRNAME_MAX 64
+
+static const char heapdump_header[] = {'u', 'j', 'h', HEAPDUMP_VERSION,
+				       0x0, 0x0, 0x0};
+
+struct heapdump {
+	FILE *out;
+	global_State *g;
+	size_t nedges; /* Counting pass: number of edges of the object. */
+	int counting; /* Non-0 if edges are counted, not written. */
+};
+
+static void heapdump_write_u64(struct heapdump *hd, uint64_t v)
+{
+	uint8_t buf[LEB128_U64_MAXSIZE];
+
+	fwrite(buf, 1, write_uleb128(buf, v), hd->out);
+}
+
+static void heapdump_write_name(struct heapdump *hd, const char *name,
+				size_t len)
+{
+	heapdump_write_u64(hd, len);
+	fwrite(name, 1, len, hd->out);
+}
+
+static void heapdump_edge(struct heapdump *hd, const GCobj *o)
+{
+	if (o == NULL)
+		return;
+
+	if (hd->counting)
+		hd->nedges++;
+	else
+		heapdump_write_u64(hd, (uint64_t)(uintptr_t)o);
+}
+
+static LJ_AINLINE void heapdump_edge_tv(struct heapdump *hd, const TValue *tv)
+{
+	if (tvisgcv(tv))
+		heapdump_edge(hd, gcV(tv));
+}
+
+/* -- Edges of objects, ORDER is the same as in lj_gc.c -------------------- */
+
+static int heapdump_weakmode(const struct heapdump *hd, GCtab *t)
+{
+	const TValue *mode = uj_meta_lookup_mt(hd->g, t->metatable, MM_mode);
+	const char *modestr;
+	int weak = 0;
+	int c;
+
+	if (mode == NULL || !tvisstr(mode))
+		return 0;
+
+	modestr = strVdata(mode);
+	while ((c = *modestr++)) {
+		if (c == 'k')
+			weak |= LJ_GC_WEAKKEY;
+		else if (c == 'v')
+			weak |= LJ_GC_WEAKVAL;
+	}
+	return weak;
+}
+
+static void heapdump_edges_tab(struct heapdump *hd, GCtab *t)
+{
+	int weak = heapdump_weakmode(hd, t);
+	size_t i;
+
+	heapdump_edge(hd, obj2gco(t->metatable));
+
+	if (!(weak & LJ_GC_WEAKVAL)) {
+		for (i = 0; i < t->asize; i++)
+			heapdump_edge_tv(hd, arrayslot(t, i));
+	}
+
+	for (i = 0; t->hmask > 0 && i <= t->hmask; i++) {
+		const Node *n = &t->node[i];
+
+		if (tvisnil(&n->val))
+			continue;
+		if (!(weak & LJ_GC_WEAKKEY))
+			heapdump_edge_tv(hd, &n->key);
+		if (!(weak & LJ_GC_WEAKVAL))
+			heapdump_edge_tv(hd, &n->val);
+	}
+}
+
+static void heapdump_edges_func(struct heapdump *hd, GCfunc *fn)
+{
+	uint32_t i;
+
+	heapdump_edge(hd, obj2gco(fn->c.env));
+
+	if (isluafunc(fn)) {
+		heapdump_edge(hd, obj2gco(funcproto(fn)));
+		for (i = 0; i < fn->l.nupvalues; i++)
+			heapdump_edge(hd, obj2gco(fn->l.uvptr[i]));
+	} else {
+		for (i = 0; i < fn->c.nupvalues; i++)
+			heapdump_edge_tv(hd, &fn->c.upvalue[i]);
+	}
+}
+
+static void heapdump_edges_proto(struct heapdump *hd, GCproto *pt)
+{
+	ptrdiff_t i;
+
+	heapdump_edge(hd, obj2gco(proto_chunkname(pt)));
+	for (i = -(ptrdiff_t)pt->sizekgc; i < 0; i++)
+		heapdump_edge(hd, proto_kgc(pt, i));
+
+#if LJ_HASJIT
+	if (pt->trace)
+		heapdump_edge(hd, obj2gco(traceref(G2J(hd->g), pt->trace)));
+#endif /* LJ_HASJIT */
+}
+
+static void heapdump_edges_thread(struct heapdump *hd, lua_State *L)
+{
+	TValue *frame = L->base - 1;
+	TValue *top = L->top;
+
+	heapdump_edge(hd, obj2gco(L->env));
+
+	for (;;) {
+		TValue *slot;
+
+		if (!frame_isdummy(L, frame))
+			heapdump_edge(hd, obj2gco(frame_func(frame)));
+		for (slot = frame + 1; slot < top; slot++)
+			heapdump_edge_tv(hd, slot);
+
+		if (frame == L->stack)
+			break;
+
+		top = !frame_iscont(frame) ? frame : frame - 1;
+		frame = frame_prev(frame);
+	}
+}
+
+#if LJ_HASJIT
+static void heapdump_edges_trace(struct heapdump *hd, GCtrace *T)
+{
+	jit_State *J = G2J(hd->g);
+	IRRef ref;
+
+	for (ref = T->nk; ref < REF_TRUE; ref++) {
+		const IRIns *ir = &T->ir[ref];
+
+		if (ir->o == IR_KGC)
+			heapdump_edge(hd, ir_kgc(ir));
+	}
+
+	if (T->link)
+		heapdump_edge(hd, obj2gco(traceref(J, T->link)));
+	if (T->nextroot)
+		heapdump_edge(hd, obj2gco(traceref(J, T->nextroot)));
+	if (T->nextside)
+		heapdump_edge(hd, obj2gco(traceref(J, T->nextside)));
+	heapdump_edge(hd, obj2gco(T->startpt));
+}
+#endif /* LJ_HASJIT */
+
+static void heapdump_edges(struct heapdump *hd, GCobj *o)
+{
+	switch (o->gch.gct) {
+	case ~LJ_TTAB:
+		heapdump_edges_tab(hd, gco2tab(o));
+		break;
+	case ~LJ_TFUNC:
+		heapdump_edges_func(hd, gco2func(o));
+		break;
+	case ~LJ_TPROTO:
+		heapdump_edges_proto(hd, gco2pt(o));
+		break;
+	case ~LJ_TTHREAD:
+		heapdump_edges_thread(hd, gco2th(o));
+		break;
+	case ~LJ_TUPVAL:
+		heapdump_edge_tv(hd, uvval(gco2uv(o)));
+		break;
+	case ~LJ_TUDATA:
+		heapdump_edge(hd, obj2gco(gco2ud(o)->metatable));
+		heapdump_edge(hd, obj2gco(gco2ud(o)->env));
+		break;
+#if LJ_HASJIT
+	case ~LJ_TTRACE:
+		heapdump_edges_trace(hd, gco2trace(o));
+		break;
+#endif /* LJ_HASJIT */
+	default:
+		break; /* Strings and cdata do not reference other objects. */
+	}
+}
+
+/* -- Sizes and names of objects ------------------------------------------- */
+
+#if LJ_HASFFI
+static size_t heapdump_cdata_sizeof(global_State *g, const GCcdata *cd)
+{
+	const CType *ct;
+
+	if (cdataisv(cd))
+		return sizecdatav(cd);
+
+	ct = ctype_raw(ctype_ctsG(g), cd->ctypeid);
+	return sizeof(GCcdata) + (ctype_hassize(ct->info) ? ct->size :
+							     CTSIZE_PTR);
+}
+#endif /* LJ_HASFFI */
+
+static size_t heapdump_sizeof(global_State *g, GCobj *o)
+{
+	switch (o->gch.gct) {
+	case ~LJ_TSTR:
+		return uj_str_sizeof(gco2str(o));
+	case ~LJ_TUPVAL:
+		return sizeof(GCupval);
+	case ~LJ_TTHREAD:
+		return sizeof(lua_State) + sizeof(TValue) * gco2th(o)->stacksize;
+	case ~LJ_TPROTO:
+		return uj_proto_sizeof(gco2pt(o));
+	case ~LJ_TFUNC:
+		return uj_func_sizeof(gco2func(o));
+#if LJ_HASJIT
+	case ~LJ_TTRACE:
+		return lj_trace_sizeof(gco2trace(o));
+#endif /* LJ_HASJIT */
+#if LJ_HASFFI
+	case ~LJ_TCDATA:
+		return heapdump_cdata_sizeof(g, gco2cd(o));
+#endif /* LJ_HASFFI */
+	case ~LJ_TTAB:
+		return lj_tab_sizeof(gco2tab(o));
+	case ~LJ_TUDATA:
+		return uj_udata_sizeof(gco2ud(o));
+	default:
+		lua_assert(0);
+		return 0;
+	}
+}
+
+static void heapdump_write_objname(struct heapdump *hd, GCobj *o)
+{
+	char name[FORMATTED_LOC_BUF_SIZE + 32];
+	const GCfunc *fn;
+
+	switch (o->gch.gct) {
+	case ~LJ_TSTR: {
+		const GCstr *s = gco2str(o);
+
+		heapdump_write_name(hd, strdata(s),
+				    s->len < HEAPDUMP_STRNAME_MAX ?
+					    s->len :
+					    HEAPDUMP_STRNAME_MAX);
+		return;
+	}
+	case ~LJ_TPROTO:
+		uj_proto_sprintloc(name, gco2pt(o), 0);
+		break;
+	case ~LJ_TFUNC:
+		fn = gco2func(o);
+		if (isluafunc(fn))
+			uj_proto_sprintloc(name, funcproto(fn), 0);
+		else if (iscfunc(fn))
+			sprintf(name, "C:%p", (void *)(uintptr_t)fn->c.f);
+		else
+			sprintf(name, "builtin#%d", (int)fn->c.ffid);
+		break;
+	default:
+		name[0] = '\0';
+		break;
+	}
+
+	heapdump_write_name(hd, name, strlen(name));
+}
+
+/* -- Walking the heap ----------------------------------------------------- */
+
+static void heapdump_object(struct heapdump *hd, GCobj *o)
+{
+	hd->counting = 1;
+	hd->nedges = 0;
+	heapdump_edges(hd, o);
+
+	fputc(o->gch.gct, hd->out);
+	heapdump_write_u64(hd, (uint64_t)(uintptr_t)o);
+	heapdump_write_u64(hd, heapdump_sizeof(hd->g, o));
+	heapdump_write_u64(hd, hd->nedges);
+
+	hd->counting = 0;
+	heapdump_edges(hd, o);
+
+	heapdump_write_objname(hd, o);
+}
+
+static void heapdump_chain(struct heapdump *hd, GCobj *o)
+{
+	for (; o != NULL; o = gcnext(o)) {
+		heapdump_object(hd, o);
+
+		/* Open upvalues are linked to their threads only. */
+		if (o->gch.gct == ~LJ_TTHREAD)
+			heapdump_chain(hd, gco2th(o)->openupval);
+	}
+}
+
+static void heapdump_strhash(struct heapdump *hd, const uj_strhash_t *strhash)
+{
+	size_t i;
+
+	if (strhash->hash == NULL)
+		return;
+
+	for (i = 0; i <= strhash->mask; i++)
+		heapdump_chain(hd, strhash->hash[i]);
+}
+
+static void heapdump_roots(struct heapdump *hd)
+{
+	global_State *g = hd->g;
+	size_t i;
+
+	/* Same as gc_mark_start in lj_gc.c. */
+	heapdump_edge(hd, obj2gco(mainthread(g)));
+	heapdump_edge(hd, obj2gco(mainthread(g)->env));
+	heapdump_edge_tv(hd, &g->registrytv);
+	for (i = 0; i < GCROOT_MAX; i++)
+		heapdump_edge(hd, g->gcroot[i]);
+	heapdump_edge(hd, obj2gco(g->dataroot));
+}
+
+void uj_dump_heap(FILE *out, lua_State *L)
+{
+	struct heapdump hd;
+	global_State *g = G(L);
+
+	/* Leave only live objects, all of them are marked the same way. */
+	lj_gc_fullgc(L);
+
+	hd.out = out;
+	hd.g = g;
+
+	fwrite(heapdump_header, 1, sizeof(heapdump_header), out);
+
+	hd.counting = 1;
+	hd.nedges = 0;
+	heapdump_roots(&hd);
+	heapdump_write_u64(&hd, hd.nedges);
+	hd.counting = 0;
+	heapdump_roots(&hd);
+
+	heapdump_chain(&hd, g->gc.root);
+	heapdump_strhash(&hd, gl_strhash(g));
+	heapdump_strhash(&hd, gl_strhash_sealed(g));
+
+	fputc(HEAPDUMP_EPILOGUE, out);
+	fflush(out);
+}
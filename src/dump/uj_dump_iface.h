@@ -48,6 +48,13 @@ void uj_dump_bc_ins(FILE *out, const GCproto *pt, const BCIns *ins,
  */
 void uj_dump_nonlua_bc_ins(FILE *out, const GCfunc *func, uint8_t nest_level);
 
+/*
+ * Run a full GC cycle and dump a snapshot of all live objects of the VM L
+ * belongs to, together with references between them, to output in binary
+ * format (see the implementation file for details).
+ */
+void uj_dump_heap(FILE *out, lua_State *L);
+
 /*
  * Dump all bytecode instructions of the function to output. If func is not a
  * Lua function (ergo does not have a bytecode), a brief function description
@@ -70,11 +77,23 @@ void uj_dump_bc_and_source(FILE *out, const GCfunc *func, BCPos hl_bc_pos);
  */
 void uj_dump_ir(FILE *out, const GCtrace *trace);
 
+/*
+ * Dump the number of exits to the interpreter taken through each snapshot
+ * of the trace to output. Snapshots which were never restored are omitted.
+ */
+void uj_dump_exits(FILE *out, const GCtrace *trace);
+
 /*
  * Dump trace mcode to output.
  */
 void uj_dump_mcode(FILE *out, const jit_State *J, const GCtrace *trace);
 
+/*
+ * Dump the number of trace aborts of the compiler J per error to output.
+ * Errors which never occurred are omitted.
+ */
+void uj_dump_aborts(FILE *out, const jit_State *J);
+
 /*
  *
  * Interfaces for dumping compiler's progress dynamically
@@ -118,7 +118,7 @@ static void dump_ir_k_native_lua(FILE *out, const IRIns *ins)
 	case IRT_NUM: {
 		double value = numV(ir_knum(ins));
 
-		uj_cstr_fromnum(kvalue, value);
+		kvalue[uj_cstr_fromnum(kvalue, value)] = '\0';
 		break;
 	}
 	default: {
@@ -644,3 +644,23 @@ void uj_dump_ir(FILE *out, const GCtrace *trace)
 	if (snap)
 		dump_snapshot(out, trace, snap, sn);
 }
+
+void uj_dump_exits(FILE *out, const GCtrace *trace)
+{
+	SnapNo sn;
+	uint64_t total = 0;
+
+	fprintf(out, "---- TRACE %d exits\n", trace->traceno);
+
+	for (sn = 0; sn < trace->nsnap; sn++) {
+		const SnapShot *snap = &trace->snap[sn];
+
+		if (snap->nexits == 0)
+			continue;
+
+		total += snap->nexits;
+		fprintf(out, "#%-3u %10u\n", (uint32_t)sn, snap->nexits);
+	}
+
+	fprintf(out, "---- TOTAL %llu\n", (unsigned long long)total);
+}
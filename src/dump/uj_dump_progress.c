@@ -215,3 +215,22 @@ int uj_dump_stop(const lua_State *L)
 	J->dump_file = NULL;
 	return 0;
 }
+
+void uj_dump_aborts(FILE *out, const jit_State *J)
+{
+	int e;
+	uint64_t total = 0;
+
+	fprintf(out, "---- ABORTS\n");
+
+	for (e = 0; e < LJ_TRERR__MAX; e++) {
+		if (J->naborts[e] == 0)
+			continue;
+
+		total += J->naborts[e];
+		fprintf(out, "%-8s %10u\n", dump_trace_error_names[e],
+			J->naborts[e]);
+	}
+
+	fprintf(out, "---- TOTAL %llu\n", (unsigned long long)total);
+}
@@ -182,7 +182,7 @@ static void dump_value_slot(FILE *out, const lua_State *L, const TValue *slot)
 		fprintf(out, ", ");
 		uj_dump_func_description(out, funcV(slot), 0);
 	} else if (tvisnum(slot)) {
-		uj_cstr_fromnum(slot_value, numV(slot));
+		slot_value[uj_cstr_fromnum(slot_value, numV(slot))] = '\0';
 	}
 
 	if (slot_value[0])
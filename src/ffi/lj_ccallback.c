@@ -33,7 +33,7 @@
 #define CALLBACK_MCODE_SIZE     (UJ_PAGESIZE * LJ_NUM_CBPAGE)
 
 #define CALLBACK_MCODE_HEAD     8
-#define CALLBACK_MCODE_GROUP    (-2+1+2+5+6)
+#define CALLBACK_MCODE_GROUP    (-2+1+2+10+6)
 
 #define CALLBACK_SLOT2OFS(slot) \
   (CALLBACK_MCODE_HEAD + CALLBACK_MCODE_GROUP*((slot)/32) + 4*(slot))
@@ -80,11 +80,13 @@ UJ_PEDANTIC_ON
     /* mov al, slot; jmp group */
     *p++ = XI_MOVrib | RID_EAX; *p++ = (uint8_t)slot;
     if ((slot & 31) == 31 || slot == CALLBACK_MAX_SLOT-1) {
-      /* push ebp/rbp; mov ah, slot>>8; mov ebp, &g. */
+      /* push rbp; mov ah, slot>>8; mov rbp, &g. */
       *p++ = XI_PUSH + RID_EBP;
       *p++ = XI_MOVrib | (RID_EAX+4); *p++ = (uint8_t)(slot >> 8);
+      /* g is not necessarily in the lower 4GB, use a 64 bit immediate. */
+      *p++ = 0x48;  /* REX.W */
       *p++ = XI_MOVri | RID_EBP;
-      *(int32_t *)p = i32ptr(g); p += 4;
+      *(uint64_t *)p = (uint64_t)(uintptr_t)g; p += 8;
       /* jmp [rip-pageofs] where lj_vm_ffi_callback is stored. */
       *p++ = XI_GROUP5; *p++ = XM_OFS0 + (XOg_JMP<<3) + RID_EBP;
       *(int32_t *)p = (int32_t)(page-(p+4)); p += 4;
@@ -127,43 +129,166 @@ void lj_ccallback_mcode_free(CTState *cts)
   munmap(p, sz);
 }
 
-/* -- C callback entry ---------------------------------------------------- */
+/* -- C callback argument conversions ------------------------------------ */
+
+/*
+** Argument conversions are computed once per callback slot when the callback
+** is created, so entering a callback does not walk the C type chains. Plain
+** numbers are converted in place, other types go through lj_cconv_tv_ct.
+*/
+
+/* Argument conversion kinds. */
+enum {
+  CALLBACK_CONV_GENERIC,  /* lj_cconv_tv_ct, may create cdata. */
+  CALLBACK_CONV_INT,      /* Signed integer of up to 32 bits. */
+  CALLBACK_CONV_UINT,     /* Unsigned integer of up to 32 bits. */
+  CALLBACK_CONV_FLOAT,    /* float. */
+  CALLBACK_CONV_DOUBLE,   /* double. */
+  CALLBACK_CONV_BOOL      /* bool. */
+};
+
+/* Argument locations. */
+enum {
+  CALLBACK_LOC_GPR,
+  CALLBACK_LOC_FPR,
+  CALLBACK_LOC_STACK
+};
 
 /* Target-specific handling of register arguments. Similar to lj_ccall.c. */
 #define CALLBACK_HANDLE_REGARG \
   if (isfp) { \
     if (nfpr + n <= CCALL_NARG_FPR) { \
-      sp = &cts->cb.fpr[nfpr]; \
+      loc = CALLBACK_LOC_FPR; \
+      idx = nfpr; \
       nfpr += n; \
       goto done; \
     } \
   } else { \
     if (ngpr + n <= maxgpr) { \
-      sp = &cts->cb.gpr[ngpr]; \
+      loc = CALLBACK_LOC_GPR; \
+      idx = ngpr; \
       ngpr += n; \
       goto done; \
     } \
   }
 
+/* Get conversion kind for a raw argument type. */
+static uint8_t callback_conv_kind(CType *cta)
+{
+  CTInfo info = cta->info;
+  if (!ctype_isnum(info))
+    return CALLBACK_CONV_GENERIC;
+  if (ctype_isbool(info))
+    return CALLBACK_CONV_BOOL;
+  if (ctype_isfp(info))
+    return cta->size == sizeof(float) ? CALLBACK_CONV_FLOAT :
+                                        CALLBACK_CONV_DOUBLE;
+  if (cta->size > 4)
+    return CALLBACK_CONV_GENERIC;
+  return (info & CTF_UNSIGNED) ? CALLBACK_CONV_UINT : CALLBACK_CONV_INT;
+}
+
+/* Compute argument conversions of a function type checked for callbacks. */
+static void callback_sig_init(CTState *cts, CType *ct, CCallbackSig *sig)
+{
+  CTypeID fid = ct->sib;
+  size_t ngpr = 0, nsp = 0, maxgpr = CCALL_NARG_GPR;
+#if CCALL_NARG_FPR
+  size_t nfpr = 0;
+#endif
+  sig->narg = 0;
+  while (fid) {
+    CType *ctf = ctype_get(cts, fid);
+    if (!ctype_isattrib(ctf->info)) {
+      CCallbackArg *arg = &sig->arg[sig->narg++];
+      CType *cta;
+      CTSize sz;
+      int isfp;
+      size_t n, idx;
+      uint8_t loc;
+      lua_assert(ctype_isfield(ctf->info));
+      lua_assert(sig->narg <= CCALLBACK_MAX_ARG);
+      cta = ctype_rawchild(cts, ctf);
+      isfp = ctype_isfp(cta->info);
+      sz = (cta->size + CTSIZE_PTR-1) & ~(CTSIZE_PTR-1);
+      n = sz / CTSIZE_PTR;  /* Number of GPRs or stack slots needed. */
+
+      CALLBACK_HANDLE_REGARG  /* Handle register arguments. */
+
+      /* Otherwise pass argument on stack. */
+      loc = CALLBACK_LOC_STACK;
+      idx = nsp;
+      nsp += n;
+
+    done:
+      arg->conv = callback_conv_kind(cta);
+      arg->loc = loc;
+      arg->idx = (uint8_t)idx;
+      arg->size = (uint8_t)cta->size;
+      arg->cid = (CTypeID1)ctype_typeid(cts, cta);
+    }
+    fid = ctf->sib;
+  }
+}
+
+/* Convert a single callback argument according to its conversion. */
+static LJ_AINLINE int callback_conv_arg(CTState *cts, const CCallbackArg *arg,
+                                        TValue *o)
+{
+  uint8_t *sp;
+  if (arg->loc == CALLBACK_LOC_GPR)
+    sp = (uint8_t *)&cts->cb.gpr[arg->idx];
+  else if (arg->loc == CALLBACK_LOC_FPR)
+    sp = (uint8_t *)&cts->cb.fpr[arg->idx];
+  else
+    sp = (uint8_t *)&cts->cb.stack[arg->idx];
+  switch (arg->conv) {
+  case CALLBACK_CONV_INT:
+    setnumV(o, (lua_Number)(arg->size == 4 ? *(int32_t *)sp :
+                            arg->size == 2 ? *(int16_t *)sp : *(int8_t *)sp));
+    return 0;
+  case CALLBACK_CONV_UINT:
+    setnumV(o, (lua_Number)(arg->size == 4 ? *(uint32_t *)sp :
+                            arg->size == 2 ? *(uint16_t *)sp : *(uint8_t *)sp));
+    return 0;
+  case CALLBACK_CONV_FLOAT:
+    setnumV(o, (lua_Number)*(float *)sp);
+    return 0;
+  case CALLBACK_CONV_DOUBLE:
+    o->n = *(double *)sp;
+    /* Numbers are NOT canonicalized here! Same as lj_cconv_tv_ct. */
+    settag(o, LJ_TNUMX);
+    return 0;
+  case CALLBACK_CONV_BOOL: {
+    uint32_t b = arg->size == 1 ? (*sp != 0) : (*(int *)sp != 0);
+    setboolV(o, b);
+    setboolV(&cts->g->tmptv2, b);  /* Remember for trace recorder. */
+    return 0;
+  }
+  default:
+    return lj_cconv_tv_ct(cts, ctype_get(cts, arg->cid), 0, o, sp);
+  }
+}
+
+/* -- C callback entry ---------------------------------------------------- */
+
 /* Convert and push callback arguments to Lua stack. */
 static void callback_conv_args(CTState *cts, lua_State *L)
 {
   TValue *o = L->top;
-  intptr_t *stack = cts->cb.stack;
   size_t slot = cts->cb.slot;
-  CTypeID id = 0, rid, fid;
+  const CCallbackSig *sig = NULL;
+  CTypeID id = 0, rid;
   int gcsteps = 0;
   CType *ct;
   GCfunc *fn;
-  size_t ngpr = 0, nsp = 0, maxgpr = CCALL_NARG_GPR;
-#if CCALL_NARG_FPR
-  size_t nfpr = 0;
-#endif
+  uint32_t i;
 
   if (slot < cts->cb.sizeid && (id = cts->cb.cbid[slot]) != 0) {
     ct = ctype_get(cts, id);
     rid = ctype_cid(ct->info);
     fn = funcV(lj_tab_getint(cts->miscmap, (int32_t)slot));
+    sig = &cts->cb.cbsig[slot];
   } else {  /* Must set up frame first, before throwing the error. */
     ct = NULL;
     rid = 0;
@@ -182,32 +307,8 @@ static void callback_conv_args(CTState *cts, lua_State *L)
   uj_state_stack_check(L, LUA_MINSTACK);  /* May throw. */
   o = L->base;  /* Might have been reallocated. */
 
-  fid = ct->sib;
-  while (fid) {
-    CType *ctf = ctype_get(cts, fid);
-    if (!ctype_isattrib(ctf->info)) {
-      CType *cta;
-      void *sp;
-      CTSize sz;
-      int isfp;
-      size_t n;
-      lua_assert(ctype_isfield(ctf->info));
-      cta = ctype_rawchild(cts, ctf);
-      isfp = ctype_isfp(cta->info);
-      sz = (cta->size + CTSIZE_PTR-1) & ~(CTSIZE_PTR-1);
-      n = sz / CTSIZE_PTR;  /* Number of GPRs or stack slots needed. */
-
-      CALLBACK_HANDLE_REGARG  /* Handle register arguments. */
-
-      /* Otherwise pass argument on stack. */
-      sp = &stack[nsp];
-      nsp += n;
-
-    done:
-      gcsteps += lj_cconv_tv_ct(cts, cta, 0, o++, sp);
-    }
-    fid = ctf->sib;
-  }
+  for (i = 0; i < sig->narg; i++)
+    gcsteps += callback_conv_arg(cts, &sig->arg[i], o++);
   L->top = o;
   while (gcsteps-- > 0)
     lj_gc_check(L);
@@ -305,7 +406,11 @@ static size_t callback_slot_new(CTState *cts, CType *ct)
                         &(cts->cb.sizeid), CALLBACK_MAX_SLOT, sizeof(CTypeID1));
   cts->cb.cbid = cbid;
   memset(cbid+top, 0, (cts->cb.sizeid-top)*sizeof(CTypeID1));
+  cts->cb.cbsig = (CCallbackSig *)uj_mem_realloc(cts->L, cts->cb.cbsig,
+                        top*sizeof(CCallbackSig),
+                        cts->cb.sizeid*sizeof(CCallbackSig));
 found:
+  callback_sig_init(cts, ct, &cts->cb.cbsig[top]);
   cbid[top] = id;
   cts->cb.topid = top+1;
   return top;
@@ -700,17 +700,25 @@ static void crec_index_meta(jit_State *J, CTState *cts, CType *ct,
   if (tvisfunc(tv)) {
     J->base[-1] = lj_ir_kfunc(J, funcV(tv)) | TREF_FRAME;
     rd->nres = -1;  /* Pending tailcall. */
-  } else if (is_newindex == 0 && tvistab(tv) && tref_isstr(J->base[1])) {
+  } else if (is_newindex == 0 && tvistab(tv) &&
+             (tref_isstr(J->base[1]) || tref_isbool(J->base[1]) ||
+              (tref_isnumber(J->base[1]) && !tvisnan(&rd->argv[1])))) {
     /* Specialize to result of __index lookup. */
+    TRef key = J->base[1];
     const TValue *o = lj_tab_get(J->L, tabV(tv), &rd->argv[1]);
     J->base[0] = lj_record_constify(J, o);
     if (!J->base[0])
       lj_trace_err(J, LJ_TRERR_BADTYPE);
-    /* Always specialize to the key. */
-    emitir(IRTG(IR_EQ, IRT_STR), J->base[1], lj_ir_kstr(J, strV(&rd->argv[1])));
+    /* Always specialize to the key. Booleans are specialized by type. */
+    if (tref_isstr(key))
+      emitir(IRTG(IR_EQ, IRT_STR), key, lj_ir_kstr(J, strV(&rd->argv[1])));
+    else if (tref_isinteger(key))
+      emitir(IRTGI(IR_EQ), key,
+             lj_ir_kint(J, lj_num2int(numV(&rd->argv[1]))));
+    else if (tref_isnum(key))
+      emitir(IRTG(IR_EQ, IRT_NUM), key, lj_ir_knum(J, numV(&rd->argv[1])));
   } else {
     /* NYI: resolving of non-function metamethods. */
-    /* NYI: non-string keys for __index table. */
     /* NYI: stores to __newindex table. */
     lj_trace_err(J, LJ_TRERR_BADTYPE);
   }
@@ -870,6 +878,24 @@ static void crec_finalizer(jit_State *J, TRef trcd, const TValue *fin)
   J->needsnap = 1;
 }
 
+/* Maximum size of a cdata object initialized element by element. */
+#define CREC_ALLOC_MAXINIT              128
+
+/* Initialize aggregate element of a new cdata object. */
+static void crec_alloc_aggregate(jit_State *J, CType *dc, TRef dp, TRef sp,
+                                 const TValue *sval)
+{
+  if (sp) {
+    /* NYI: init aggregates with tables or multiple values. */
+    if (!tref_iscdata(sp))
+      lj_trace_err(J, LJ_TRERR_NYICONV);
+    crec_ct_tv(J, dc, dp, sp, sval);  /* Copy aggregate. */
+  } else {
+    crec_fill(J, dp, lj_ir_kint(J, (int32_t)dc->size), lj_ir_kint(J, 0),
+              1u << ctype_align(dc->info));
+  }
+}
+
 /* Record cdata allocation. */
 static void crec_alloc(jit_State *J, RecordFFData *rd, CTypeID id)
 {
@@ -878,8 +904,12 @@ static void crec_alloc(jit_State *J, RecordFFData *rd, CTypeID id)
   CTInfo info = lj_ctype_info(cts, id, &sz);
   CType *d = ctype_raw(cts, id);
   TRef trid;
-  if (!sz || sz > 128 || (info & CTF_VLA) || ctype_align(info) > CT_MEMALIGN)
-    lj_trace_err(J, LJ_TRERR_NYICONV);  /* NYI: large/special allocations. */
+  if (!sz || (info & CTF_VLA) || ctype_align(info) > CT_MEMALIGN)
+    lj_trace_err(J, LJ_TRERR_NYICONV);  /* NYI: special allocations. */
+  /* Large objects are either cleared or copied from a single initializer. */
+  if (sz > CREC_ALLOC_MAXINIT && J->base[1] &&
+      (J->base[2] || lj_cconv_multi_init(cts, d, &rd->argv[1])))
+    lj_trace_err(J, LJ_TRERR_NYICONV);  /* NYI: init large aggregates. */
   trid = lj_ir_kint(J, id);
   /* Use special instruction to box pointer or 32/64 bit integer. */
   if (ctype_isptr(info) || (ctype_isinteger(info) && (sz == 4 || sz == 8))) {
@@ -894,6 +924,12 @@ static void crec_alloc(jit_State *J, RecordFFData *rd, CTypeID id)
     if (J->base[1] && !J->base[2] &&
         !lj_cconv_multi_init(cts, d, &rd->argv[1])) {
       goto single_init;
+    } else if (sz > CREC_ALLOC_MAXINIT) {
+      TRef dp = emitir(IRT(IR_ADD, IRT_PTR), trcd,
+                       lj_ir_kintp(J, sizeof(GCcdata)));
+      lua_assert(!J->base[1]);
+      crec_fill(J, dp, lj_ir_kint(J, (int32_t)sz), lj_ir_kint(J, 0),
+                1u << ctype_align(info));
     } else if (ctype_isarray(d->info)) {
       CType *dc = ctype_rawchild(cts, d);  /* Array element type. */
       CTSize ofs, esize = dc->size;
@@ -901,9 +937,10 @@ static void crec_alloc(jit_State *J, RecordFFData *rd, CTypeID id)
       TValue tv;
       TValue *sval = &tv;
       size_t i;
+      int isagg = ctype_isstruct(dc->info) || ctype_isarray(dc->info);
       setrawV(&tv, 0);
-      if (!(ctype_isnum(dc->info) || ctype_isptr(dc->info)))
-        lj_trace_err(J, LJ_TRERR_NYICONV);  /* NYI: init array of aggregates. */
+      if (!(ctype_isnum(dc->info) || ctype_isptr(dc->info) || isagg))
+        lj_trace_err(J, LJ_TRERR_NYICONV);  /* NYI: init array of vectors. */
       for (i = 1, ofs = 0; ofs < sz; ofs += esize) {
         TRef dp = emitir(IRT(IR_ADD, IRT_PTR), trcd,
                          lj_ir_kintp(J, ofs + sizeof(GCcdata)));
@@ -912,9 +949,12 @@ static void crec_alloc(jit_State *J, RecordFFData *rd, CTypeID id)
           sval = &rd->argv[i];
           i++;
         } else if (i != 2) {
-          sp = ctype_isnum(dc->info) ? lj_ir_kint(J, 0) : TREF_NIL;
+          sp = isagg ? 0 : ctype_isnum(dc->info) ? lj_ir_kint(J, 0) : TREF_NIL;
         }
-        crec_ct_tv(J, dc, dp, sp, sval);
+        if (isagg)
+          crec_alloc_aggregate(J, dc, dp, sp, sval);
+        else
+          crec_ct_tv(J, dc, dp, sp, sval);
       }
     } else if (ctype_isstruct(d->info)) {
       CTypeID fid = d->sib;
@@ -930,19 +970,34 @@ static void crec_alloc(jit_State *J, RecordFFData *rd, CTypeID id)
           setintV(&tv, 0);
           if (df->name == NULL) continue;  /* Ignore unnamed fields. */
           dc = ctype_rawchild(cts, df);  /* Field type. */
-          if (!(ctype_isnum(dc->info) || ctype_isptr(dc->info) ||
-                ctype_isenum(dc->info)))
-            lj_trace_err(J, LJ_TRERR_NYICONV);  /* NYI: init aggregates. */
-          if (J->base[i]) {
+          dp = emitir(IRT(IR_ADD, IRT_PTR), trcd,
+                      lj_ir_kintp(J, df->size + sizeof(GCcdata)));
+          if (ctype_isstruct(dc->info) || ctype_isarray(dc->info)) {
             sp = J->base[i];
-            sval = &rd->argv[i];
-            i++;
+            if (sp) {
+              sval = &rd->argv[i];
+              i++;
+            }
+            crec_alloc_aggregate(J, dc, dp, sp, sval);
           } else {
-            sp = ctype_isptr(dc->info) ? TREF_NIL : lj_ir_kint(J, 0);
+            if (!(ctype_isnum(dc->info) || ctype_isptr(dc->info) ||
+                  ctype_isenum(dc->info)))
+              lj_trace_err(J, LJ_TRERR_NYICONV);  /* NYI: init vectors. */
+            if (J->base[i]) {
+              sp = J->base[i];
+              sval = &rd->argv[i];
+              i++;
+            } else {
+              sp = ctype_isptr(dc->info) ? TREF_NIL : lj_ir_kint(J, 0);
+            }
+            crec_ct_tv(J, dc, dp, sp, sval);
+          }
+          /* Only the first member of a union is initialized. */
+          if ((d->info & CTF_UNION)) {
+            if (d->size != dc->size)  /* NYI: partial init of union. */
+              lj_trace_err(J, LJ_TRERR_NYICONV);
+            break;
           }
-          dp = emitir(IRT(IR_ADD, IRT_PTR), trcd,
-                      lj_ir_kintp(J, df->size + sizeof(GCcdata)));
-          crec_ct_tv(J, dc, dp, sp, sval);
         } else if (!ctype_isconstval(df->info)) {
           /* NYI: init bitfields and sub-structures. */
           lj_trace_err(J, LJ_TRERR_NYICONV);
@@ -1203,10 +1258,13 @@ static TRef crec_arith_ptr(jit_State *J, TRef *sp, CType **s, enum MMS mm)
       if (mm == MM_sub) {  /* Pointer difference. */
         TRef tr;
         CTSize sz = lj_ctype_size(cts, ctype_cid(ctp->info));
-        if (sz == 0 || (sz & (sz-1)) != 0)
-          return 0;  /* NYI: integer division. */
+        if (sz == 0 || sz == CTSIZE_INVALID)
+          return 0;
         tr = emitir(IRT(IR_SUB, IRT_INTP), sp[0], sp[1]);
-        tr = emitir(IRT(IR_BSAR, IRT_INTP), tr, lj_ir_kint(J, lj_bsr(sz)));
+        if ((sz & (sz-1)) == 0)
+          tr = emitir(IRT(IR_BSAR, IRT_INTP), tr, lj_ir_kint(J, lj_bsr(sz)));
+        else  /* 64 bit division is a call, see asm_arith64. */
+          tr = emitir(IRT(IR_DIV, IRT_INTP), tr, lj_ir_kintp(J, sz));
         tr = emitconv(tr, IRT_NUM, IRT_INTP, 0);
         return tr;
       } else {  /* Pointer comparison (unsigned). */
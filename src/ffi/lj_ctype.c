@@ -14,11 +14,13 @@
 #include "uj_mem.h"
 #include "uj_err.h"
 #include "uj_str.h"
+#include "uj_sbuf.h"
 #include "lj_tab.h"
 #include "uj_meta.h"
 #include "ffi/lj_ctype.h"
 #include "ffi/lj_ccallback.h"
 #include "utils/fp.h"
+#include "utils/leb128.h"
 
 /* -- C type definitions -------------------------------------------------- */
 
@@ -603,6 +605,189 @@ GCstr *lj_ctype_repr_complex(lua_State *L, void *sp, CTSize size)
   return uj_str_new(L, buf, len+1);
 }
 
+/* -- Saving and loading C types ------------------------------------------ */
+
+/*
+** Saved C types are a prologue followed by all C type elements above the
+** built-in ones:
+**
+**   magic top:ULEB { info:ULEB size:ULEB sib:ULEB flags:ULEB [name] }*
+**   name := len:ULEB bytes
+**
+** flags is a combination of CTSAVE_* below. Type IDs are preserved, so C
+** types can be loaded only into a state without user-defined C types. Names
+** are hashed by their addresses, so hash chains are rebuilt on loading.
+*/
+
+#define CTSAVE_MAGIC     "\033UJT\001"
+#define CTSAVE_MAGICLEN  (sizeof(CTSAVE_MAGIC)-1)
+#define CTSAVE_HASHED    0x1   /* Element is in a hash chain. */
+#define CTSAVE_NAMED     0x2   /* Element has a name. */
+
+/* Check whether a type element is reachable from its hash anchor. */
+static int ctype_ishashed(CTState *cts, CType *ct, CTypeID id)
+{
+  CTypeID i = ct->name ? cts->hash[ct_hashname(ct->name)] :
+                         cts->hash[ct_hashtype(ct->info, ct->size)];
+  for (; i; i = ctype_get(cts, i)->next)
+    if (i == id) return 1;
+  return 0;
+}
+
+/* Save all user-defined C types to a buffer. */
+void lj_ctype_save(CTState *cts, struct sbuf *sb)
+{
+  CTypeID id;
+  uj_sbuf_push_block(sb, CTSAVE_MAGIC, CTSAVE_MAGICLEN);
+  uj_sbuf_push_uleb128(sb, cts->top);
+  for (id = CTTYPEINFO_NUM; id < cts->top; id++) {
+    CType *ct = ctype_get(cts, id);
+    uint32_t flags = ctype_ishashed(cts, ct, id) ? CTSAVE_HASHED : 0;
+    if (ct->name) flags |= CTSAVE_NAMED;
+    uj_sbuf_push_uleb128(sb, ct->info);
+    uj_sbuf_push_uleb128(sb, ct->size);
+    uj_sbuf_push_uleb128(sb, ct->sib);
+    uj_sbuf_push_uleb128(sb, flags);
+    if (ct->name) {
+      uj_sbuf_push_uleb128(sb, ct->name->len);
+      uj_sbuf_push_block(sb, strdata(ct->name), ct->name->len);
+    }
+  }
+}
+
+typedef struct CTLoad {
+  const uint8_t *p;     /* Current position. */
+  const uint8_t *pe;    /* End of data. */
+} CTLoad;
+
+/* Read ULEB128 value, returns 0 for malformed data. */
+static int ctype_load_uleb128(CTLoad *ctl, uint64_t *v)
+{
+  size_t n = read_uleb128_n(v, ctl->p, (size_t)(ctl->pe - ctl->p));
+  ctl->p += n;
+  return n != 0;
+}
+
+/* Check whether the element refers to another type with its cid. */
+static int ctype_load_hascid(CTInfo info)
+{
+  return ctype_isptr(info) || ctype_isarray(info) || ctype_isenum(info) ||
+         ctype_isfunc(info) || ctype_istypedef(info) ||
+         ctype_isattrib(info) || ctype_isfield(info) ||
+         ctype_isconstval(info) || ctype_isextern(info);
+}
+
+/* Check that a type element refers to valid type IDs only. */
+static int ctype_load_check(CType *ct, CTypeID top)
+{
+  CTInfo info = ct->info;
+  if (ctype_type(info) >= CT_KW || ct->sib >= top)
+    return 0;
+  if (ctype_load_hascid(info))
+    return ctype_cid(info) < top;
+  return 1;
+}
+
+/* Next element of a sib or a cid chain, 0 at the end of the chain. */
+static CTypeID ctype_load_next(CTState *cts, CTypeID id, int bycid)
+{
+  CType *ct = ctype_get(cts, id);
+  if (!bycid)
+    return ct->sib;
+  return ctype_load_hascid(ct->info) ? ctype_cid(ct->info) : 0;
+}
+
+/* Check that all sib or cid chains of loaded elements terminate.
+** mark[] has an entry per type: 0 - not visited yet, 1 - on the current
+** chain, 2 - the chain is known to terminate. Predefined types are trusted.
+*/
+static int ctype_load_acyclic(CTState *cts, uint8_t *mark, int bycid)
+{
+  CTypeID id, i;
+  memset(mark, 0, cts->top);
+  for (id = CTTYPEINFO_NUM; id < cts->top; id++) {
+    for (i = id; i >= CTTYPEINFO_NUM && mark[i] == 0;
+         i = ctype_load_next(cts, i, bycid))
+      mark[i] = 1;
+    if (i >= CTTYPEINFO_NUM && mark[i] == 1)
+      return 0;  /* Cycle. */
+    for (i = id; i >= CTTYPEINFO_NUM && mark[i] == 1;
+         i = ctype_load_next(cts, i, bycid))
+      mark[i] = 2;
+  }
+  return 1;
+}
+
+/* Load one type element, returns 0 for malformed data. */
+static int ctype_load_one(CTState *cts, CTLoad *ctl, CTypeID top)
+{
+  uint64_t info, size, sib, flags, len;
+  CType *ct;
+  CTypeID id;
+  if (!ctype_load_uleb128(ctl, &info) || !ctype_load_uleb128(ctl, &size) ||
+      !ctype_load_uleb128(ctl, &sib) || !ctype_load_uleb128(ctl, &flags) ||
+      info > 0xffffffffu || size > 0xffffffffu || sib >= top)
+    return 0;
+  id = lj_ctype_new(cts, &ct);
+  ct->info = (CTInfo)info;
+  ct->size = (CTSize)size;
+  ct->sib = (CTypeID1)sib;
+  if (!ctype_load_check(ct, top))
+    return 0;
+  if ((flags & CTSAVE_NAMED)) {
+    if (!ctype_load_uleb128(ctl, &len) || len > (uint64_t)(ctl->pe - ctl->p))
+      return 0;
+    ctype_setname(ct, uj_str_new(cts->L, (const char *)ctl->p, (size_t)len));
+    ctl->p += len;
+  }
+  if ((flags & CTSAVE_HASHED)) {
+    if (ct->name)
+      lj_ctype_addname(cts, ct, id);
+    else
+      ctype_addtype(cts, ct, id);
+  }
+  return 1;
+}
+
+/* Load C types saved with lj_ctype_save. */
+void lj_ctype_load(CTState *cts, const uint8_t *buf, size_t len)
+{
+  CTLoad ctl;
+  uint64_t top;
+  uint8_t *mark;
+  int acyclic;
+  LJ_CTYPE_SAVE(cts);
+  if (cts->top != CTTYPEINFO_NUM)
+    uj_err(cts->L, UJ_ERR_FFI_LOADDEF);
+  ctl.p = buf;
+  ctl.pe = buf + len;
+  if (len < CTSAVE_MAGICLEN || memcmp(buf, CTSAVE_MAGIC, CTSAVE_MAGICLEN))
+    uj_err(cts->L, UJ_ERR_FFI_LOADBAD);
+  ctl.p += CTSAVE_MAGICLEN;
+  if (!ctype_load_uleb128(&ctl, &top) ||
+      top < CTTYPEINFO_NUM || top > CTID_MAX)
+    uj_err(cts->L, UJ_ERR_FFI_LOADBAD);
+  while (cts->top < (CTypeID)top) {
+    if (!ctype_load_one(cts, &ctl, (CTypeID)top)) {
+      LJ_CTYPE_RESTORE(cts);
+      uj_err(cts->L, UJ_ERR_FFI_LOADBAD);
+    }
+  }
+  if (ctl.p != ctl.pe) {
+    LJ_CTYPE_RESTORE(cts);
+    uj_err(cts->L, UJ_ERR_FFI_LOADBAD);
+  }
+  /* Looping chains would hang type lookups and size computations. */
+  mark = (uint8_t *)uj_mem_alloc(cts->L, cts->top);
+  acyclic = ctype_load_acyclic(cts, mark, 0) &&
+            ctype_load_acyclic(cts, mark, 1);
+  uj_mem_free(MEM(cts->L), mark, cts->top);
+  if (!acyclic) {
+    LJ_CTYPE_RESTORE(cts);
+    uj_err(cts->L, UJ_ERR_FFI_LOADBAD);
+  }
+}
+
 /* -- C type state -------------------------------------------------------- */
 
 /* Initialize C type table and state. */
@@ -655,6 +840,8 @@ void lj_ctype_freestate(global_State *g)
     lj_ccallback_mcode_free(cts);
     uj_mem_free(MEM_G(g), cts->tab, cts->sizetab * sizeof(CType));
     uj_mem_free(MEM_G(g), cts->cb.cbid, cts->cb.sizeid * sizeof(CTypeID1));
+    uj_mem_free(MEM_G(g), cts->cb.cbsig,
+                cts->cb.sizeid * sizeof(CCallbackSig));
     uj_mem_free(MEM_G(g), cts, sizeof(*cts));
   }
 }
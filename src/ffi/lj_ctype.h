@@ -192,6 +192,24 @@ typedef struct CType {
 
 typedef LJ_ALIGN(8) union FPRCBArg { double d; float f[2]; } FPRCBArg;
 
+/* Max. number of callback arguments, see callback_checkfunc. */
+#define CCALLBACK_MAX_ARG       (LUA_MINSTACK-4)
+
+/* Precomputed conversion of a callback argument. */
+typedef struct CCallbackArg {
+  uint8_t conv;         /* Conversion kind, see lj_ccallback.c. */
+  uint8_t loc;          /* Location: GPR, FPR or stack. */
+  uint8_t idx;          /* Index of register or stack slot. */
+  uint8_t size;         /* Size of C type. */
+  CTypeID1 cid;         /* Raw C type of argument. */
+} CCallbackArg;
+
+/* Precomputed argument conversions of a callback slot. */
+typedef struct CCallbackSig {
+  uint32_t narg;        /* Number of arguments. */
+  CCallbackArg arg[CCALLBACK_MAX_ARG];
+} CCallbackSig;
+
 /* C callback state. Defined here, to avoid dragging in lj_ccall.h. */
 
 typedef LJ_ALIGN(8) struct CCallback {
@@ -200,6 +218,7 @@ typedef LJ_ALIGN(8) struct CCallback {
   intptr_t *stack;              /* Pointer to arguments on stack. */
   void *mcode;                  /* Machine code for callback func. pointers. */
   CTypeID1 *cbid;               /* Callback type table. */
+  CCallbackSig *cbsig;          /* Callback argument conversions. */
   size_t sizeid;                        /* Size of callback type table. */
   size_t topid;                 /* Highest unused callback type table slot. */
   size_t slot;                  /* Current callback slot. */
@@ -468,6 +487,8 @@ const TValue *lj_ctype_meta(CTState *cts, CTypeID id, enum MMS mm);
 GCstr *lj_ctype_repr(lua_State *L, CTypeID id, GCstr *name);
 GCstr *lj_ctype_repr_int64(lua_State *L, uint64_t n, int isunsigned);
 GCstr *lj_ctype_repr_complex(lua_State *L, void *sp, CTSize size);
+void lj_ctype_save(CTState *cts, struct sbuf *sb);
+void lj_ctype_load(CTState *cts, const uint8_t *buf, size_t len);
 CTState *lj_ctype_init(lua_State *L);
 void lj_ctype_freestate(global_State *g);
 
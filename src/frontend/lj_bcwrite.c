@@ -152,14 +152,19 @@ static void bcwrite_knum(BCWriteCtx *ctx, GCproto *pt)
   }
 }
 
-/* Zeroing counter and flag fields for HOTCNT in dump */
-static void bcwrite_zero_hotcnt(BCIns *bc, size_t nbc)
+/*
+** Zeroing counter and flag fields for HOTCNT in dump, fused instructions
+** are dumped in their original form.
+*/
+static void bcwrite_normalize(BCIns *bc, size_t nbc)
 {
   BCIns *end = bc + nbc;
 
   while (bc != end) {
     if (bc_op(*bc) == BC_HOTCNT)
       *(BCIns *)bc = (BCIns)BC_HOTCNT;
+    else if (bc_op(*bc) == BC_TGETSS)
+      setbc_op(bc, BC_TGETS);
     bc++;
   }
 }
@@ -176,7 +181,7 @@ static void bcwrite_bytecode(BCWriteCtx *ctx, GCproto *pt)
 #endif /* LJ_HASJIT */
 
   uj_sbuf_push_block(sb, proto_bc(pt) + 1, nbc * sizeof(BCIns));
-  bcwrite_zero_hotcnt((BCIns *)uj_sbuf_at(sb, bc_pos), nbc);
+  bcwrite_normalize((BCIns *)uj_sbuf_at(sb, bc_pos), nbc);
 #if LJ_HASJIT
   uint8_t *p = (uint8_t *)uj_sbuf_at(sb, n);
 
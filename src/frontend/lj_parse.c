@@ -26,6 +26,7 @@
 #endif /* LJ_HASFFI */
 #include "frontend/lj_lex.h"
 #include "frontend/lj_parse.h"
+#include "frontend/uj_bcopt.h"
 #include "lj_vm.h"
 #include "utils/uj_math.h"
 #include "uj_hotcnt.h"
@@ -1483,6 +1484,8 @@ static GCproto *fs_finish(LexState *ls, BCLine line)
   /* Apply final fixups. */
   fs_fixup_ret(fs);
 
+  uj_bcopt_fs(fs);
+
 #ifdef UJIT_COVERAGE
   if (uj_coverage_enabled(L))
     uj_coverage_emit(fs);
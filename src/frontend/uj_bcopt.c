@@ -0,0 +1,162 @@
+/*
+ * Post-parse optimization of the generated bytecode.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ *
+ * The pass works on the bytecode stack of a FuncState right before the
+ * prototype is allocated. Currently it does the following:
+ *
+ * With -Xbcopt=on:
+ *
+ *  * Jump threading: a JMP which lands on a chain of unconditional forward
+ *    JMPs is redirected to the final destination. Comparisons and tests use
+ *    the JMP following them as a branch slot, so compare-and-jump pairs get
+ *    their taken branch threaded as well.
+ *  * Return duplication: an unconditional JMP which lands on RET0/RET1/RET
+ *    is replaced with a copy of the return instruction.
+ *
+ * Both transformations remove a dispatch from the interpreter and shorten
+ * recorded bytecode sequences.
+ *
+ * With -Xsuperins=on (only if built with UJIT_ENABLE_SUPERINS):
+ *
+ *  * Superinstruction fusion: TGETS followed by another TGETS (field chains
+ *    like a.b.c and consecutive field loads) becomes TGETSS, which enters
+ *    the handler of the next instruction without an indirect jump.
+ *
+ * Instructions are never added or removed, so line info and variable ranges
+ * stay intact.
+ */
+
+#include "lj_obj.h"
+#include "lj_bc.h"
+#include "frontend/lj_lex.h"
+#include "frontend/lj_parse.h"
+#include "frontend/uj_bcopt.h"
+#ifdef UJIT_COVERAGE
+#include "uj_coverage.h"
+#endif /* UJIT_COVERAGE */
+
+static LJ_AINLINE BCIns bcopt_ins(const struct FuncState *fs, BCPos pc)
+{
+	return fs->bcbase[pc].ins;
+}
+
+static LJ_AINLINE BCPos bcopt_target(const struct FuncState *fs, BCPos pc)
+{
+	return (BCPos)((ptrdiff_t)pc + 1 + bc_j(bcopt_ins(fs, pc)));
+}
+
+/* Returns 1 if the JMP at pc can be patched to jump to dest, 0 otherwise. */
+static LJ_AINLINE int bcopt_in_range(BCPos pc, BCPos dest)
+{
+	ptrdiff_t offset = (ptrdiff_t)dest - (ptrdiff_t)(pc + 1) + BCBIAS_J;
+
+	return offset >= 0 && offset <= BCMAX_D;
+}
+
+/* Comparisons and tests use the subsequent JMP as a branch slot. */
+static LJ_AINLINE int bcopt_is_cond(BCOp op)
+{
+	return op <= BC_ISF;
+}
+
+/* Returns 1 if the instruction at pc is a JMP which can be jumped through. */
+static int bcopt_is_threadable(const struct FuncState *fs, BCPos pc)
+{
+	BCPos target;
+	BCOp op;
+
+	if (bc_op(bcopt_ins(fs, pc)) != BC_JMP)
+		return 0;
+
+	/* Backward jumps are loop back-edges, leave them alone. */
+	target = bcopt_target(fs, pc);
+	if (target <= pc)
+		return 0;
+
+	/* JMPs to iterator calls open for-in loops, leave them alone, too. */
+	op = bc_op(bcopt_ins(fs, target));
+	return op != BC_ITERC && op != BC_ITERN;
+}
+
+static void bcopt_jmp(struct FuncState *fs, BCPos pc)
+{
+	BCIns ins = bcopt_ins(fs, pc);
+	BCReg ra = bc_a(ins);
+	BCPos target = bcopt_target(fs, pc);
+	BCOp op;
+
+	/*
+	 * Every hop goes forward, so the loop terminates. JMP's operand A is
+	 * used by the recorder to shrink the set of live slots, and a jump
+	 * through the chain would pass all intermediate JMPs, so the minimum
+	 * of their operands is taken.
+	 */
+	while (bcopt_is_threadable(fs, target)) {
+		BCIns next = bcopt_ins(fs, target);
+		BCPos dest = bcopt_target(fs, target);
+
+		if (!bcopt_in_range(pc, dest))
+			break;
+
+		if (bc_a(next) < ra)
+			ra = bc_a(next);
+		target = dest;
+	}
+
+	op = bc_op(bcopt_ins(fs, target));
+	if ((op == BC_RET0 || op == BC_RET1 || op == BC_RET) &&
+	    !bcopt_is_cond(bc_op(bcopt_ins(fs, pc - 1)))) {
+		fs->bcbase[pc].ins = bcopt_ins(fs, target);
+		return;
+	}
+
+	fs->bcbase[pc].ins = BCINS_AJ(BC_JMP, ra, target - (pc + 1));
+}
+
+static void bcopt_thread(struct FuncState *fs)
+{
+	BCPos pc;
+
+	/* Slot 0 is reserved for the function header. */
+	for (pc = 1; pc < fs->pc; pc++) {
+		if (bc_op(bcopt_ins(fs, pc)) == BC_JMP)
+			bcopt_jmp(fs, pc);
+	}
+}
+
+#ifdef UJIT_SUPERINS
+static void bcopt_fuse(struct FuncState *fs)
+{
+	BCPos pc;
+
+	for (pc = 1; pc + 1 < fs->pc; pc++) {
+		if (bc_op(bcopt_ins(fs, pc)) == BC_TGETS &&
+		    bc_op(bcopt_ins(fs, pc + 1)) == BC_TGETS)
+			setbc_op(&fs->bcbase[pc].ins, BC_TGETSS);
+	}
+}
+#endif /* UJIT_SUPERINS */
+
+void uj_bcopt_fs(struct FuncState *fs)
+{
+	const global_State *g = G(fs->L);
+
+#ifdef UJIT_COVERAGE
+	/*
+	 * Threading may skip lines which are expected in coverage reports,
+	 * and COVERG instructions may be inserted between fused ones.
+	 */
+	if (uj_coverage_enabled(fs->L))
+		return;
+#endif /* UJIT_COVERAGE */
+
+	if (g->enable_bcopt)
+		bcopt_thread(fs);
+
+#ifdef UJIT_SUPERINS
+	if (g->enable_superins)
+		bcopt_fuse(fs);
+#endif /* UJIT_SUPERINS */
+}
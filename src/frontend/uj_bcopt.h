@@ -0,0 +1,21 @@
+/*
+ * Post-parse optimization of the generated bytecode.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#ifndef _UJ_BCOPT_H
+#define _UJ_BCOPT_H
+
+struct FuncState;
+
+/*
+ * Optimizes the bytecode of the function being finished in-place according to
+ * the options the VM was created with. Must be called after all final fixups
+ * are applied and before the bytecode is copied to the prototype. The pass
+ * never changes the number of instructions, so line info and variable info
+ * stay valid.
+ */
+void uj_bcopt_fs(struct FuncState *fs);
+
+#endif /* !_UJ_BCOPT_H */
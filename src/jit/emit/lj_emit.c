@@ -42,6 +42,23 @@ void emit_rr(ASMState *as, x86Op xo, Reg r1, Reg r2) {
   as->mcp = emit_opm(xo, XM_REG, r1, r2, p, 0);
 }
 
+/* shlx/shrx/sarx dest, src, count
+** BMI2 shifts have a VEX-encoded count operand and don't touch the flags.
+*/
+void emit_shiftx(ASMState *as, x86Shift xs, Reg dest, Reg src, Reg count) {
+  MCode *p = as->mcp;
+  /* Opcode extension of the VEX prefix: 66 - shlx, f3 - sarx, f2 - shrx. */
+  MCode pp = (xs & 7) == XOg_SHL ? 1 : (xs & 7) == XOg_SAR ? 2 : 3;
+  dest &= 15; src &= 15; count &= 15;
+  p[-1] = MODRM(XM_REG, dest, src);
+  p[-2] = 0xf7;
+  p[-3] = (MCode)(((xs & REX_64) == REX_64 ? 0x80 : 0) |
+                  ((~count & 15) << 3) | pp);
+  p[-4] = (MCode)(((~dest & 8) << 4) | 0x40 | ((~src & 8) << 2) | 0x02);
+  p[-5] = 0xc4;
+  as->mcp = p - 5;
+}
+
 /* mov r, imm64
 ** Forced 8-byte version.
 */
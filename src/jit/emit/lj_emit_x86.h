@@ -46,6 +46,9 @@ MCode *emit_op(x86Op xo, Reg rr, Reg rb, Reg rx, MCode *p, int delta);
 /* op r1, r2 */
 void emit_rr(ASMState *as, x86Op xo, Reg r1, Reg r2);
 
+/* shlx/shrx/sarx dest, src, count (BMI2 only) */
+void emit_shiftx(ASMState *as, x86Shift xs, Reg dest, Reg src, Reg count);
+
 #define ptr2addr(p)     (i32ptr((p)))                  /* Low dword of ptr. */
 
 /* mov r, imm64
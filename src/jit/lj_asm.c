@@ -936,13 +936,74 @@ static void asm_phi_shuffle(ASMState *as)
   }
 }
 
+/* Copy of a right PHI spill slot to the left PHI spill slot. */
+typedef struct PhiCopy {
+  IRIns *ir;  /* PHI instruction. */
+  int32_t from, to;  /* Spill slot offsets. */
+} PhiCopy;
+
+/* Copy unsynced left/right PHI spill slots of one register class via r.
+**
+** The copies are a parallel move: a left slot may also be the right slot of
+** another PHI. So copies are ordered to read each slot before overwriting it
+** and cycles are broken by saving one slot to a temporary spill slot.
+*/
+static void asm_phi_copyspill_class(ASMState *as, Reg r, int fp)
+{
+  PhiCopy pend[LJ_MAX_PHI], seq[2*LJ_MAX_PHI];
+  int32_t tmp = 0;
+  int npend = 0, nseq = 0;
+  IRIns *ir;
+  for (ir = IR(as->orignins-1); ir->o == IR_PHI; ir--) {
+    IRIns *irl = IR(ir->op1);
+    if (ra_hasspill(ir->s) && ra_hasspill(irl->s) && irl->s != ir->s &&
+        !irt_isfp(ir->t) == !fp) {
+      pend[npend].ir = ir;
+      pend[npend].from = sps_scale(ir->s);
+      pend[npend].to = sps_scale(irl->s);
+      npend++;
+    }
+  }
+  while (npend) {
+    int i, j;
+    for (i = 0; i < npend; i++) {  /* Find a copy to a slot nobody reads. */
+      for (j = 0; j < npend; j++)
+        if (pend[j].from == pend[i].to) break;
+      if (j == npend) break;
+    }
+    if (i == npend) {  /* Only cycles left, break one. */
+      if (!tmp) {
+        tmp = sps_scale(as->evenspill);
+        as->evenspill += 2;
+        if (as->evenspill > 256)
+          lj_trace_err(as->J, LJ_TRERR_SPILLOV);
+      }
+      i = 0;
+      seq[nseq].ir = pend[i].ir;
+      seq[nseq].from = pend[i].to;
+      seq[nseq].to = tmp;
+      nseq++;
+      for (j = 0; j < npend; j++)
+        if (pend[j].from == pend[i].to) pend[j].from = tmp;
+    }
+    seq[nseq++] = pend[i];
+    pend[i] = pend[--npend];
+  }
+  while (nseq--) {  /* Emitted backwards, executed in order. */
+    emit_spstore(as, seq[nseq].ir, r, seq[nseq].to);
+    emit_spload(as, seq[nseq].ir, r, seq[nseq].from);
+    checkmclim(as);
+  }
+}
+
 /* Copy unsynced left/right PHI spill slots. Rarely needed. */
 static void asm_phi_copyspill(ASMState *as)
 {
   int need = 0;
   IRIns *ir;
   for (ir = IR(as->orignins-1); ir->o == IR_PHI; ir--)
-    if (ra_hasspill(ir->s) && ra_hasspill(IR(ir->op1)->s))
+    if (ra_hasspill(ir->s) && ra_hasspill(IR(ir->op1)->s) &&
+        IR(ir->op1)->s != ir->s)
       need |= irt_isfp(ir->t) ? 2 : 1;  /* Unsynced spill slot? */
   if ((need & 1)) {  /* Copy integer spill slots. */
     Reg r = RID_RET;
@@ -950,16 +1011,7 @@ static void asm_phi_copyspill(ASMState *as)
       r = rset_pickbot((as->freeset & RSET_GPR));
     else
       emit_spload(as, IR(regcost_ref(as->cost[r])), r, SPOFS_TMP);
-    for (ir = IR(as->orignins-1); ir->o == IR_PHI; ir--) {
-      if (ra_hasspill(ir->s)) {
-        IRIns *irl = IR(ir->op1);
-        if (ra_hasspill(irl->s) && !irt_isfp(ir->t)) {
-          emit_spstore(as, irl, r, sps_scale(irl->s));
-          emit_spload(as, ir, r, sps_scale(ir->s));
-          checkmclim(as);
-        }
-      }
-    }
+    asm_phi_copyspill_class(as, r, 0);
     if (!rset_test(as->freeset, r))
       emit_spstore(as, IR(regcost_ref(as->cost[r])), r, SPOFS_TMP);
   }
@@ -969,21 +1021,30 @@ static void asm_phi_copyspill(ASMState *as)
       r = rset_pickbot((as->freeset & RSET_FPR));
     if (!rset_test(as->freeset, r))
       emit_spload(as, IR(regcost_ref(as->cost[r])), r, SPOFS_TMP);
-    for (ir = IR(as->orignins-1); ir->o == IR_PHI; ir--) {
-      if (ra_hasspill(ir->s)) {
-        IRIns *irl = IR(ir->op1);
-        if (ra_hasspill(irl->s) && irt_isfp(ir->t)) {
-          emit_spstore(as, irl, r, sps_scale(irl->s));
-          emit_spload(as, ir, r, sps_scale(ir->s));
-          checkmclim(as);
-        }
-      }
-    }
+    asm_phi_copyspill_class(as, r, 1);
     if (!rset_test(as->freeset, r))
       emit_spstore(as, IR(regcost_ref(as->cost[r])), r, SPOFS_TMP);
   }
 }
 
+/* Restore left PHIs of spilled PHIs from their spill slots at the loop start.
+** The slot is synced with the right PHI slot on each iteration, while the
+** register is not.
+*/
+static void asm_phi_restore(ASMState *as)
+{
+  IRIns *ir;
+  for (ir = IR(as->orignins-1); ir->o == IR_PHI; ir--) {
+    if (ir->r != RID_SINK && ra_hasspill(ir->s) &&
+        ra_hasreg(IR(ir->op1)->r)) {
+      if (irref_isk(ir->op1))  /* Constants are never stored to a slot. */
+        lj_trace_err(as->J, LJ_TRERR_NYIPHI);
+      ra_restore(as, ir->op1);
+      checkmclim(as);
+    }
+  }
+}
+
 /* Emit renames for left PHIs which are only spilled outside the loop. */
 static void asm_phi_fixup(ASMState *as)
 {
@@ -1018,9 +1079,6 @@ static void asm_phi(ASMState *as, IRIns *ir)
   IRIns *irr = IR(ir->op2);
   if (ir->r == RID_SINK)  /* Sink PHI. */
     return;
-  /* Spill slot shuffling is not implemented yet (but rarely needed). */
-  if (ra_hasspill(irl->s) || ra_hasspill(irr->s))
-    lj_trace_err(as->J, LJ_TRERR_NYIPHI);
   /* Leave at least one register free for non-PHIs (and PHI cycle breaking). */
   if ((afree & (afree-1))) {  /* Two or more free registers? */
     Reg r;
@@ -1037,11 +1095,12 @@ static void asm_phi(ASMState *as, IRIns *ir)
     if (ra_noreg(irl->r))
       ra_sethint(irl->r, r); /* Set register hint for left PHI. */
   } else {  /* Otherwise allocate a spill slot. */
-    /* This is overly restrictive, but it triggers only on synthetic code. */
-    if (ra_hasreg(irl->r) || ra_hasreg(irr->r))
-      lj_trace_err(as->J, LJ_TRERR_NYIPHI);
-    ra_spill(as, ir);
-    irr->s = ir->s;  /* Set right PHI spill slot. Sync left slot later. */
+    if (ra_hasspill(irr->s)) {  /* Duplicate right PHI, share its slot. */
+      ir->s = irr->s;
+    } else {
+      ra_spill(as, ir);
+      irr->s = ir->s;  /* Set right PHI spill slot. Sync left slot later. */
+    }
   }
 }
 
@@ -1058,6 +1117,7 @@ static void asm_loop(ASMState *as)
   /* LOOP marks the transition from the variant to the invariant part. */
   as->flagmcp = as->invmcp = NULL;
   as->sectref = 0;
+  asm_phi_restore(as);
   asm_phi_shuffle(as);
   mcspill = as->mcp;
   asm_phi_copyspill(as);
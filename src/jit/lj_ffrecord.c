@@ -1093,25 +1093,32 @@ static void recff_string_find(jit_State *J, RecordFFData *rd)
   }
 }
 
-static void recff_string_format(jit_State *J, RecordFFData *rd)
+/* Put operations used for recording of format strings. */
+typedef struct RecordFormatOps {
+  /* Append a string. */
+  TRef (*str)(jit_State *J, TRef trb, TRef trs);
+  /* Append a number or an integer the same way tostring converts it. */
+  TRef (*num)(jit_State *J, TRef trb, TRef tr);
+  /* Append a number converted to integer. */
+  TRef (*numint)(jit_State *J, TRef trb, TRef tr);
+} RecordFormatOps;
+
+/* Record formatting of arguments following the format string in slot
+** narg to the buffer trb. Returns the resulting buffer reference or 0 if
+** the interpreter will throw.
+*/
+static TRef recff_format(jit_State *J, RecordFFData *rd, BCReg narg, TRef trb,
+                         const RecordFormatOps *ops)
 {
-  TRef trfmt, tr, hdr;
-  const GCstr *strfmt;
-  const char *fmt, *fmt_end;
-  int arg = 1;
-
-  if (!(J->flags & JIT_F_OPT_JITSTR))
-    recff_nyi(J, rd);
-
-  trfmt = lj_ir_tostr(J, J->base[0]);
-  strfmt = argv2str(J, &rd->argv[0]);
-  fmt = strdata(strfmt);
-  fmt_end = fmt + strfmt->len;
+  TRef trfmt = lj_ir_tostr(J, J->base[narg]);
+  const GCstr *strfmt = argv2str(J, &rd->argv[narg]);
+  const char *fmt = strdata(strfmt);
+  const char *fmt_end = fmt + strfmt->len;
+  BCReg arg = narg + 1;
 
   /* Specialize to the format string. */
   emitir(IRTG(IR_EQ, IRT_STR), trfmt, lj_ir_kstr(J, strfmt));
 
-  tr = hdr = recff_bufhdr(J);
   while (fmt < fmt_end) {
     TRef tra;
 
@@ -1120,13 +1127,12 @@ static void recff_string_format(jit_State *J, RecordFFData *rd)
 
       while(*fmt != '%' && fmt < fmt_end)
         fmt++;
-      tr = emitir(IRT(IR_BUFPUT, IRT_PTR), tr,
-                  lj_ir_kstr(J, uj_str_new(J->L, start, fmt - start)));
+      trb = ops->str(J, trb,
+                     lj_ir_kstr(J, uj_str_new(J->L, start, fmt - start)));
       continue;
     }
     if (*++fmt == '%') {  /* %% */
-      tr = emitir(IRT(IR_BUFPUT, IRT_PTR), tr,
-                  lj_ir_kstr(J, uj_str_new(J->L, "%", 1)));
+      trb = ops->str(J, trb, lj_ir_kstr(J, uj_str_new(J->L, "%", 1)));
       ++fmt;
       continue;
     }
@@ -1134,33 +1140,63 @@ static void recff_string_format(jit_State *J, RecordFFData *rd)
     tra = J->base[arg++];
 
     if (!tra)
-      return; /* Interpreter will throw */
+      return 0; /* Interpreter will throw */
 
     switch (*fmt++) {
     case 'd':  case 'i': {  /* %d and %i */
       if (tref_isinteger(tra))
-        tr = emitir(IRT(IR_BUFPUT, IRT_PTR), tr,
-                    emitir(IRT(IR_TOSTR, IRT_STR), tra, 0));
+        trb = ops->num(J, trb, tra);
       else
-        tr = lj_ir_call(J, IRCALL_uj_sbuf_push_numint, tr, lj_ir_tonum(J, tra));
+        trb = ops->numint(J, trb, lj_ir_tonum(J, tra));
       break;
     }
     case 's': {  /* %s */
-      if (!tref_isstr(tra)) {
-        if (tref_isnum(tra) || tref_isinteger(tra))
-          tra = emitir(IRT(IR_TOSTR, IRT_STR), tra, 0);
-        else
-          recff_nyiu(J);  /* NYI: __tostring and non-string types */
-      }
-      tr = emitir(IRT(IR_BUFPUT, IRT_PTR), tr, tra);
+      if (tref_isstr(tra))
+        trb = ops->str(J, trb, tra);
+      else if (tref_isnum(tra) || tref_isinteger(tra))
+        trb = ops->num(J, trb, tra);
+      else
+        recff_nyiu(J);  /* NYI: __tostring and non-string types */
       break;
     }
     default:
       recff_nyiu(J);
     }
   }
+  return trb;
+}
 
-  J->base[0] = emitir(IRT(IR_BUFSTR, IRT_STR), tr, hdr);
+static TRef recff_bufput_str(jit_State *J, TRef trb, TRef trs)
+{
+  return emitir(IRT(IR_BUFPUT, IRT_PTR), trb, trs);
+}
+
+static TRef recff_bufput_num(jit_State *J, TRef trb, TRef tr)
+{
+  return emitir(IRT(IR_BUFPUT, IRT_PTR), trb,
+                emitir(IRT(IR_TOSTR, IRT_STR), tr, 0));
+}
+
+static TRef recff_bufput_numint(jit_State *J, TRef trb, TRef tr)
+{
+  return lj_ir_call(J, IRCALL_uj_sbuf_push_numint, trb, tr);
+}
+
+static const RecordFormatOps recff_bufput_ops = {
+  recff_bufput_str, recff_bufput_num, recff_bufput_numint
+};
+
+static void recff_string_format(jit_State *J, RecordFFData *rd)
+{
+  TRef tr, hdr;
+
+  if (!(J->flags & JIT_F_OPT_JITSTR))
+    recff_nyi(J, rd);
+
+  hdr = recff_bufhdr(J);
+  tr = recff_format(J, rd, 0, hdr, &recff_bufput_ops);
+  if (tr)
+    J->base[0] = emitir(IRT(IR_BUFSTR, IRT_STR), tr, hdr);
 }
 
 /* -- Table library fast functions ---------------------------------------- */
@@ -1302,6 +1338,41 @@ static void recff_ujit_table_toset(jit_State *J, RecordFFData *rd)
   UNUSED(rd);
 }
 
+static void recff_ujit_table_new(jit_State *J, RecordFFData *rd)
+{
+  TRef tra = J->base[0];
+  TRef trh = J->base[1];
+  if (tref_isnumber(tra) && tref_isnumber(trh)) {
+    tra = lj_opt_narrow_toint(J, tra);
+    trh = lj_opt_narrow_toint(J, trh);
+    if (tref_isk(tra) && tref_isk(trh)) {
+      int32_t a = IR(tref_ref(tra))->i;
+      int32_t h = IR(tref_ref(trh))->i;
+      if (a < 0x7fff) {  /* Sizes of TNEW are literals. */
+        uint32_t asize = a > 0 ? (uint32_t)a + 1 : 0;
+        uint32_t hbits = h > 0 ? hsize2hbits(h) : 0;
+        J->base[0] = emitir(IRTG(IR_TNEW, IRT_TAB), asize, hbits);
+        return;
+      }
+    }
+    J->base[0] = lj_ir_call(J, IRCALL_lj_tab_new_ah, tra, trh);
+  } else {
+    recff_nyiu(J);
+  }
+  UNUSED(rd);
+}
+
+static void recff_ujit_table_clear(jit_State *J, RecordFFData *rd)
+{
+  TRef tr = J->base[0];
+  if (tref_istab(tr)) {
+    lj_ir_emit_immutable_guard(J, tr);
+    lj_ir_call(J, IRCALL_lj_tab_clear, tr);
+    rd->nres = 0;
+    J->needsnap = 1;
+  }  /* else: Interpreter will throw. */
+}
+
 static void recff_ujit_table_size(jit_State *J, RecordFFData *rd)
 {
   if (tref_istab(J->base[0]))
@@ -1430,6 +1501,213 @@ static void recff_ujit_string_trim(jit_State *J, RecordFFData *rd)
   UNUSED(rd);
 }
 
+/* Record a boolean string predicate, specialized to its runtime result. */
+static void recff_ujit_string_pred(jit_State *J, RecordFFData *rd,
+                                   IRCallID id, int res)
+{
+  TRef tr;
+
+  if (!(tref_isstr(J->base[0]) && tref_isstr(J->base[1])))
+    recff_nyiu(J);
+
+  tr = lj_ir_call(J, id, J->base[0], J->base[1]);
+  emitir(IRTGI(res ? IR_NE : IR_EQ), tr, lj_ir_kint(J, 0));
+  J->base[0] = res ? TREF_TRUE : TREF_FALSE;
+  UNUSED(rd);
+}
+
+static void recff_ujit_string_startswith(jit_State *J, RecordFFData *rd)
+{
+  int res = tvisstr(&rd->argv[0]) && tvisstr(&rd->argv[1]) &&
+            uj_str_startswith(strV(&rd->argv[0]), strV(&rd->argv[1]));
+  recff_ujit_string_pred(J, rd, IRCALL_uj_str_startswith, res);
+}
+
+static void recff_ujit_string_endswith(jit_State *J, RecordFFData *rd)
+{
+  int res = tvisstr(&rd->argv[0]) && tvisstr(&rd->argv[1]) &&
+            uj_str_endswith(strV(&rd->argv[0]), strV(&rd->argv[1]));
+  recff_ujit_string_pred(J, rd, IRCALL_uj_str_endswith, res);
+}
+
+static void recff_ujit_string_count(jit_State *J, RecordFFData *rd)
+{
+  TRef trsub = J->base[1];
+
+  if (!(tref_isstr(J->base[0]) && tref_isstr(trsub)))
+    recff_nyiu(J);
+
+  /* Specialize to non-empty substring, the interpreter throws otherwise. */
+  if (strV(&rd->argv[1])->len == 0)
+    recff_nyiu(J);
+  emitir(IRTGI(IR_NE), emitir(IRTI(IR_FLOAD), trsub, IRFL_STR_LEN),
+         lj_ir_kint(J, 0));
+  J->base[0] = lj_ir_call(J, IRCALL_uj_str_count, J->base[0], trsub);
+}
+
+static void recff_ujit_string_split(jit_State *J, RecordFFData *rd)
+{
+  TRef trstr = J->base[0];
+  TRef trsep = J->base[1];
+
+  if (!(tref_isstr(trstr) && tref_isstr(trsep)))
+    recff_nyiu(J);
+
+  /* Specialize to non-empty separator, the interpreter throws otherwise. */
+  if (strV(&rd->argv[1])->len == 0)
+    recff_nyiu(J);
+  emitir(IRTGI(IR_NE), emitir(IRTI(IR_FLOAD), trsep, IRFL_STR_LEN),
+         lj_ir_kint(J, 0));
+
+  J->base[0] = lj_ir_call(J, IRCALL_lj_ujit_string_splitter, trsep);
+  J->base[1] = trstr;
+  rd->nres = 2;
+}
+
+/*
+** Iterator returned by ujit.string.split. The closure is created anew for each
+** loop, so calls are specialized to its fast function id rather than to its
+** identity (see rec_call_specialize). Upvalues hold the separator and the raw
+** cursor, the latter is read and advanced in place.
+*/
+static void recff_ujit_string_split_aux(jit_State *J, RecordFFData *rd)
+{
+  const GCfunc *fn = J->fn;
+  const GCstr *str, *sep;
+  size_t i;
+  TRef trfn, trsep, trcur, tri, trstr, trlen, trsptr, trfind, trj;
+
+  if (!tref_isstr(J->base[0]))
+    recff_nyiu(J);
+
+  str = strV(&rd->argv[0]);
+  sep = strV(&fn->c.upvalue[0]);
+  i = (size_t)rawV(&fn->c.upvalue[1]);
+
+  /* Specialize to the separator, it is fixed for the lifetime of a closure. */
+  trfn = J->base[-1] & ~TREF_FLAGMASK;
+  trsep = emitir(IRT(IR_ADD, IRT_PTR), trfn,
+                 lj_ir_kintp(J, offsetof(GCfuncC, upvalue[0])));
+  trsep = emitir(IRT(IR_XLOAD, IRT_STR), trsep, IRXLOAD_READONLY);
+  emitir(IRTG(IR_EQ, IRT_STR), trsep, lj_ir_kstr(J, sep));
+
+  /* The cursor never exceeds len + seplen, its low word suffices. */
+  trcur = emitir(IRT(IR_ADD, IRT_PTR), trfn,
+                 lj_ir_kintp(J, offsetof(GCfuncC, upvalue[1])));
+  tri = emitir(IRTI(IR_XLOAD), trcur, 0);
+
+  trstr = J->base[0];
+  trlen = emitir(IRTI(IR_FLOAD), trstr, IRFL_STR_LEN);
+  if (i > str->len) {
+    emitir(IRTGI(IR_UGT), tri, trlen);
+    J->base[0] = TREF_NIL;
+    return;
+  }
+  emitir(IRTGI(IR_ULE), tri, trlen);
+
+  /* uj_cstr_find never matches in an empty tail, no need to special-case. */
+  trsptr = emitir(IRT(IR_STRREF, IRT_PTR), trstr, tri);
+  trfind = lj_ir_call(J, IRCALL_uj_cstr_find, trsptr,
+                      emitir(IRT(IR_STRREF, IRT_PTR), lj_ir_kstr(J, sep),
+                             lj_ir_kint(J, 0)),
+                      emitir(IRTI(IR_SUB), trlen, tri),
+                      lj_ir_kint(J, (int32_t)sep->len));
+  if (uj_cstr_find(strdata(str) + i, strdata(sep), str->len - i, sep->len)) {
+    emitir(IRTG(IR_NE, IRT_PTR), trfind, lj_ir_kkptr(J, NULL));
+    trj = emitir(IRTI(IR_ADD), tri, emitir(IRTI(IR_SUB), trfind, trsptr));
+  } else {
+    emitir(IRTG(IR_EQ, IRT_PTR), trfind, lj_ir_kkptr(J, NULL));
+    trj = trlen;
+  }
+
+  /* All guards are emitted above: the store must not be replayed on exit. */
+  emitir(IRT(IR_XSTORE, IRT_INT), trcur,
+         emitir(IRTI(IR_ADD), trj, lj_ir_kint(J, (int32_t)sep->len)));
+  J->needsnap = 1;
+
+  J->base[0] = emitir(IRT(IR_SNEW, IRT_STR), trsptr,
+                      emitir(IRTI(IR_SUB), trj, tri));
+  UNUSED(rd);
+}
+
+/* -- ujit.string.buffer methods ------------------------------------------ */
+
+/* Get a reference to the struct sbuf of a string buffer in slot 0. */
+static TRef recff_strbuf(jit_State *J, RecordFFData *rd)
+{
+  TRef tr = J->base[0];
+
+  if (!(tref_isudata(tr) && tvisstrbuf(&rd->argv[0])))
+    recff_nyiu(J);
+
+  /* Specialize to the type of userdata. */
+  emitir(IRTGI(IR_EQ), emitir(IRT(IR_FLOAD, IRT_U8), tr, IRFL_UDATA_UDTYPE),
+         lj_ir_kint(J, UDTYPE_STR_BUF));
+  return emitir(IRT(IR_ADD, IRT_PTR), tr, lj_ir_kintp(J, sizeof(GCudata)));
+}
+
+/* Buffer puts have side effects, unlike BUFPUT which is CSE'd and DCE'd. */
+static TRef recff_strbuf_put_str(jit_State *J, TRef trb, TRef trs)
+{
+  return lj_ir_call(J, IRCALL_uj_strbuf_put_str, trb, trs);
+}
+
+static TRef recff_strbuf_put_num(jit_State *J, TRef trb, TRef tr)
+{
+  if (tref_isinteger(tr))
+    return lj_ir_call(J, IRCALL_uj_strbuf_put_int, trb, tr);
+  return lj_ir_call(J, IRCALL_uj_strbuf_put_number, trb, tr);
+}
+
+static TRef recff_strbuf_put_numint(jit_State *J, TRef trb, TRef tr)
+{
+  return lj_ir_call(J, IRCALL_uj_strbuf_put_numint, trb, tr);
+}
+
+static const RecordFormatOps recff_strbuf_ops = {
+  recff_strbuf_put_str, recff_strbuf_put_num, recff_strbuf_put_numint
+};
+
+static void recff_ujit_strbuf_put(jit_State *J, RecordFFData *rd)
+{
+  TRef trb = recff_strbuf(J, rd);
+  BCReg i;
+
+  for (i = 1; J->base[i] != 0; i++) {
+    TRef tr = J->base[i];
+
+    if (tref_isstr(tr))
+      trb = recff_strbuf_put_str(J, trb, tr);
+    else if (tref_isnum(tr) || tref_isinteger(tr))
+      trb = recff_strbuf_put_num(J, trb, tr);
+    else
+      recff_nyiu(J);
+  }
+  J->needsnap = 1;
+}
+
+static void recff_ujit_strbuf_putf(jit_State *J, RecordFFData *rd)
+{
+  TRef trb = recff_strbuf(J, rd);
+
+  if (J->base[1] == 0)
+    return;  /* Interpreter will throw. */
+
+  recff_format(J, rd, 1, trb, &recff_strbuf_ops);
+  J->needsnap = 1;
+}
+
+static void recff_ujit_strbuf_reset(jit_State *J, RecordFFData *rd)
+{
+  lj_ir_call(J, IRCALL_uj_strbuf_reset, recff_strbuf(J, rd));
+  J->needsnap = 1;
+}
+
+static void recff_ujit_strbuf_tostring(jit_State *J, RecordFFData *rd)
+{
+  J->base[0] = lj_ir_call(J, IRCALL_uj_str_frombuf, recff_strbuf(J, rd));
+}
+
 /* -- Record calls to fast functions -------------------------------------- */
 
 #include "lj_recdef.h"
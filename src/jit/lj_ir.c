@@ -18,6 +18,7 @@
 #include "uj_dispatch.h"
 #include "uj_mem.h"
 #include "uj_str.h"
+#include "uj_strbuf.h"
 #include "lj_tab.h"
 #include "jit/lj_ir.h"
 #include "jit/lj_jit.h"
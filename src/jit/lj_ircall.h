@@ -82,8 +82,14 @@ typedef struct CCallInfo {
   _(ANY,        uj_str_fromint,         2,         N, STR, CCI_L) \
   _(ANY,        uj_str_fromnumber,      2,         N, STR, CCI_L) \
   _(ANY,        uj_str_trim,            2,         N, STR, CCI_L|CCI_ALLOC) \
+  _(ANY,        uj_str_startswith,      2,         N, INT, 0) \
+  _(ANY,        uj_str_endswith,        2,         N, INT, 0) \
+  _(ANY,        uj_str_count,           2,         N, INT, 0) \
+  _(ANY,        lj_ujit_string_splitter, 2,        S, FUNC, CCI_L|CCI_ALLOC) \
   _(ANY,        lj_tab_new_jit,         2,         S, TAB, CCI_L) \
   _(ANY,        lj_tab_dup,             2,         S, TAB, CCI_L) \
+  _(ANY,        lj_tab_new_ah,          3,         S, TAB, CCI_L|CCI_ALLOC) \
+  _(ANY,        lj_tab_clear,           1,         S, NIL, 0) \
   _(ANY,        lj_tab_newkey,          3,         S, P32, CCI_L) \
   _(ANY,        lj_tab_len,             1,         L, INT, 0) \
   _(ANY,        lj_tab_size,            1,         L, INT, CCI_NOFPRCLOBBER) \
@@ -107,6 +113,11 @@ typedef struct CCallInfo {
   _(ANY,        uj_sbuf_push_number,    2,         L, PTR, 0) \
   _(ANY,        uj_sbuf_push_int,       2,         L, PTR, 0) \
   _(ANY,        uj_sbuf_push_block,     3,         L, PTR, 0) \
+  _(ANY,        uj_strbuf_put_str,      3,         S, PTR, CCI_L) \
+  _(ANY,        uj_strbuf_put_int,      3,         S, PTR, CCI_L) \
+  _(ANY,        uj_strbuf_put_number,   3,         S, PTR, CCI_L) \
+  _(ANY,        uj_strbuf_put_numint,   3,         S, PTR, CCI_L) \
+  _(ANY,        uj_strbuf_reset,        1,         S, NIL, 0) \
   _(ANY,        uj_obj_immutable,       2,         S, NIL, CCI_L|CCI_IMMUTABLE|CCI_NOFPRCLOBBER) \
   _(ANY,        lj_tab_keys,            2,         L, TAB, CCI_L|CCI_ALLOC) \
   _(ANY,        lj_tab_values,          2,         L, TAB, CCI_L|CCI_ALLOC) \
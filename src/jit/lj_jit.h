@@ -19,7 +19,7 @@
 /*
  * Layout of JIT engine flags (0 - free, 1 - used):
  * +MSB---------------------------------LSB+
- * |0011-1111-1111-1111-1111-0000-1111-0001|
+ * |0011-1111-1111-1111-1111-0001-1111-0001|
  * +---------------------------------------+
  */
 
@@ -31,10 +31,11 @@
 #define JIT_F_SSE2              0x00000020
 #define JIT_F_SSE3              0x00000040
 #define JIT_F_SSE4_1            0x00000080
+#define JIT_F_BMI2              0x00000100
 
 /* Names for the CPU-specific flags. Must match the order above. */
 #define JIT_F_CPU_FIRST         JIT_F_CMOV
-#define JIT_F_CPUSTRING         "\4CMOV\4SSE2\4SSE3\6SSE4.1"
+#define JIT_F_CPUSTRING         "\4CMOV\4SSE2\4SSE3\6SSE4.1\4BMI2"
 
 /* Optimization flags. */
 #define JIT_F_OPT_MASK          0xfffff000
@@ -59,8 +60,8 @@
 #define JIT_F_OPT_MOVTVPRI      0x20000000
 
 /*
- * JIT_F_OPT_FUSE is a no-op under x86-64, and the flag is preserved for
- * compatibility only.
+ * JIT_F_OPT_FUSE enables fusion of cdata address arithmetic into memory
+ * operands of XLOAD and XSTORE.
  */
 
 /* Optimizations names for -O. Must match the order above. */
@@ -109,6 +110,7 @@
   _(\007, hotloop,      56)     /* # of iter. to detect a hot loop/call. */ \
   _(\007, hotexit,      10)     /* # of taken exits to start a side trace. */ \
   _(\007, tryside,      4)      /* # of attempts to compile a side trace. */ \
+  _(\007, retrace,      0)      /* # of re-recordings of a root trace. */ \
   \
   _(\012, instunroll,   4)      /* Max. unroll for instable loops. */ \
   _(\012, loopunroll,   15)     /* Max. unroll for loop ops in side traces. */ \
@@ -165,6 +167,7 @@ typedef struct SnapShot {
   uint8_t topslot;      /* Maximum frame extent. */
   uint8_t nent;         /* Number of compressed entries. */
   uint8_t count;        /* Count of taken exits for this snapshot. */
+  uint32_t nexits;      /* Count of restorations from this snapshot. */
 } SnapShot;
 
 #define SNAPCOUNT_DONE  255     /* Already compiled and linked a side trace. */
@@ -284,6 +287,14 @@ typedef struct HotPenalty {
 #define PENALTY_MAX     60000   /* Maximum penalty value. */
 #define PENALTY_RNDBITS 4       /* # of random bits to add to penalty value. */
 
+/* Cache of re-recording counts of root traces. */
+typedef struct RetraceEntry {
+  const BCIns *pc;      /* Starting bytecode PC. */
+  uint32_t count;       /* Number of re-recordings. */
+} RetraceEntry;
+
+#define RETRACE_SLOTS   64      /* Re-recording cache slots. */
+
 /* Round-robin backpropagation cache for narrowing conversions. */
 typedef struct BPropEntry {
   IRRef1 key;           /* Key: original reference. */
@@ -323,6 +334,13 @@ typedef struct FoldState {
   IRIns right;          /* Instruction referenced by right operand. */
 } FoldState;
 
+/* Trace errors. */
+typedef enum {
+#define TREDEF(name, msg)       LJ_TRERR_##name,
+#include "jit/lj_traceerr.h"
+  LJ_TRERR__MAX
+} TraceError;
+
 /* Abort context for a given Lua state. */
 typedef struct AbortState {
   lua_State   *L;  /* State that triggered abort. */
@@ -407,6 +425,9 @@ typedef struct jit_State {
   BCIns *patchpc;       /* PC for pending re-patch. */
   BCIns patchins;       /* Instruction for pending re-patch. */
 
+  RetraceEntry retrace[RETRACE_SLOTS]; /* Re-recording counts. */
+  uint32_t nretrace;    /* Number of used re-recording slots. */
+
   int mcprot;           /* Protection of current mcode area. */
   MCode *mcarea;        /* Base of current mcode area. */
   MCode *mctop;         /* Top of current mcode area. */
@@ -418,9 +439,16 @@ typedef struct jit_State {
                         ** "belonging" to the given jit_State
                         ** since the last call to luaE_metrics(). */
   size_t nflushall;     /* Number of successfull global flushes for the state. */
+  size_t compile_ns;    /* Time spent in the compiler (all traces) and */
+  size_t compile_ns_max; /* for the longest single trace since the last
+                        ** call to luaE_metrics(). */
+  size_t compile_ns_cur; /* Time spent in the compiler for the current trace. */
   FILE *dump_file;      /* if non-NULL: descriptor for dumping compiler's progress */
+  struct perfjit *perfjit; /* if non-NULL: state of emitting traces for perf */
 
   AbortState abortstate; /* Substate filled on each trace abort. */
+  uint32_t naborts[LJ_TRERR__MAX]; /* Number of trace aborts per error
+                        ** since the last call to luaE_metrics(). */
 }
 jit_State;
 
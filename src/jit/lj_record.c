@@ -659,6 +659,11 @@ static TRef rec_call_specialize(jit_State *J, GCfunc *fn, TRef tr)
       (void)lj_ir_kgc(J, obj2gco(pt), IRT_PROTO);  /* Prevent GC of proto. */
       return tr;
     }
+  } else if (fn->c.ffid == FF_ujit_string_split_aux) {
+    /* A new iterator closure per loop: specialize to the fast function. */
+    TRef trffid = emitir(IRTI(IR_FLOAD), tr, IRFL_FUNC_FFID);
+    emitir(IRTGI(IR_EQ), trffid, lj_ir_kint(J, FF_ujit_string_split_aux));
+    return tr;
   }
   /* Otherwise specialize to the function (closure) value itself. */
   kfunc = lj_ir_kfunc(J, fn);
@@ -2091,7 +2096,7 @@ void lj_record_ins(jit_State *J)
     setintV(&ix.keyv, (int32_t)rc);
     ix.key = lj_ir_kint(J, (int32_t)rc);
     /* fallthrough */
-  case BC_TGETV: case BC_TGETS: case BC_TSETV: case BC_TSETS:
+  case BC_TGETV: case BC_TGETS: case BC_TGETSS: case BC_TSETV: case BC_TSETS:
     ix.idxchain = LJ_MAX_IDXCHAIN;
     rc = uj_record_indexed(J, &ix);
     break;
@@ -140,6 +140,7 @@ static void snapshot_stack(jit_State *J, SnapShot *snap, size_t nsnapmap)
   snap->nent = (uint8_t)nent;
   snap->nslots = (uint8_t)nslots;
   snap->count = 0;
+  snap->nexits = 0;
   J->cur.nsnapmap = (uint32_t)(nsnapmap + nent + 2*(1 + J->framedepth));
 }
 
@@ -852,6 +853,9 @@ BCIns *lj_snap_restore(jit_State *J, void *exptr)
   }
 
   J->nsnaprestore++;
+  /* Unlike count, keeps growing after a side trace attempt is given up. */
+  if (LJ_LIKELY(snap->nexits != UINT32_MAX))
+    snap->nexits++;
 
   return pc;
 }
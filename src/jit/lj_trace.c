@@ -11,6 +11,8 @@
 
 #if LJ_HASJIT
 
+#include <time.h>
+
 #include "lj_gc.h"
 #include "uj_mem.h"
 #include "uj_throw.h"
@@ -26,6 +28,7 @@
 #include "jit/lj_snap.h"
 #include "uj_gdbjit.h"
 #include "uj_vtunejit.h"
+#include "uj_perfjit.h"
 #include "jit/lj_record.h"
 #include "jit/lj_asm.h"
 #include "uj_dispatch.h"
@@ -165,6 +168,7 @@ static void trace_save(jit_State *J, GCtrace *T)
   lj_gc_barriertrace(J2G(J), T->traceno);
   uj_gdbjit_addtrace(J, T);
   uj_vtunejit_addtrace(J, T);
+  uj_perfjit_addtrace(J, T);
 }
 
 size_t lj_trace_sizeof(GCtrace *T) {
@@ -288,6 +292,9 @@ int lj_trace_flushall(lua_State *L) {
   J->freetrace = 0;
   /* Clear penalty cache. */
   memset(J->penalty, 0, sizeof(J->penalty));
+  /* Clear re-recording cache. */
+  memset(J->retrace, 0, sizeof(J->retrace));
+  J->nretrace = 0;
   /* Free the whole machine code and invalidate all exit stub groups. */
   lj_mcode_free(J);
   memset(J->exitstubgroup, 0, sizeof(J->exitstubgroup));
@@ -319,6 +326,7 @@ void lj_trace_freestate(global_State *g)
       lua_assert(i == (ptrdiff_t)J->cur.traceno || traceref(J, i) == NULL);
   }
 #endif
+  uj_perfjit_stop(J);
   lj_mcode_free(J);
   lj_ir_k64_freeall(J);
   uj_mem_free(MEM_G(g), J->snapmapbuf, J->sizesnapmap * sizeof(SnapEntry));
@@ -455,6 +463,7 @@ static void trace_stop(jit_State *J)
     lua_assert(T != 0 && J->cur.root != 0);
     lj_asm_patchexit(J, T, J->exitno, J->cur.mcode);
     uj_vtunejit_updtrace(J, T);
+    uj_perfjit_updtrace(J, T);
     /* Avoid compiling a side trace twice (stack resizing uses parent exit). */
     T->snap[J->exitno].count = SNAPCOUNT_DONE;
     /* Add to side trace chain in root trace. */
@@ -506,6 +515,8 @@ static int trace_abort(jit_State *J)
     J->state = LJ_TRACE_ASM;
     return 1;  /* Retry ASM with new MCode area. */
   }
+  if (J->naborts[e] < UINT32_MAX)
+    J->naborts[e]++;
   /* Penalize or blacklist starting bytecode instruction. */
   if (J->parent == 0 && !bc_isret(bc_op(J->cur.startins)))
     penalty_pc(J, J->cur.startpt, J->cur.startpc, e);
@@ -617,18 +628,44 @@ static TValue *trace_state(lua_State *L, lua_CFunction dummy, void *ud)
 
 /* -- Event handling ------------------------------------------------------ */
 
+/* Current time of the monotonic clock, in nanoseconds. */
+static size_t trace_clock_ns(void)
+{
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+    return 0;
+  return (size_t)ts.tv_sec * 1000000000 + (size_t)ts.tv_nsec;
+}
+
+/* Account time spent in the compiler since start for the metrics. */
+static void trace_clock_account(jit_State *J, size_t start)
+{
+  size_t elapsed = trace_clock_ns() - start;
+  J->compile_ns += elapsed;
+  J->compile_ns_cur += elapsed;
+  if (J->state == LJ_TRACE_IDLE) {  /* Trace is either finished or aborted. */
+    if (J->compile_ns_cur > J->compile_ns_max)
+      J->compile_ns_max = J->compile_ns_cur;
+    J->compile_ns_cur = 0;
+  }
+}
+
 /* A bytecode instruction is about to be executed. Record it. */
 void lj_trace_ins(jit_State *J, const BCIns *pc)
 {
   /* Note: J->L must already be set. pc is the true bytecode PC here. */
+  size_t start = trace_clock_ns();
 #ifndef NDEBUG
   ptrdiff_t delta = J->L->top - J->L->base;
 #endif /* !NDEBUG */
+  if (J->state == LJ_TRACE_START)  /* Discard time of a trace aborted */
+    J->compile_ns_cur = 0;         /* outside the compiler, if any. */
   J->pc = pc;
   J->fn = curr_func(J->L);
   J->pt = isluafunc(J->fn) ? funcproto(J->fn) : NULL;
   while (lj_vm_cpcall(J->L, NULL, (void *)J, trace_state) != 0)
     J->state = LJ_TRACE_ERR;
+  trace_clock_account(J, start);
   lua_assert(J->L->top - J->L->base == delta);
 }
 
@@ -653,6 +690,70 @@ void lj_trace_hot(jit_State *J, const BCIns *pc)
   errno_restore(olderr);
 }
 
+/* Check whether pc is outside of the loop started by the root trace T. */
+static int trace_isloopexit(const GCtrace *T, const BCIns *pc)
+{
+  const GCproto *pt = T->startpt;
+  const BCIns *startpc = T->startpc;
+  const BCIns *first, *last;
+  if (pc < proto_bc(pt) || pc >= proto_bc(pt) + pt->sizebc)
+    return 0;  /* Exit to a callee or a caller. */
+  switch (bc_op(T->startins)) {
+  case BC_LOOP:  /* Loop head, jumps to the loop exit. */
+    first = startpc;
+    last = startpc + bc_j(T->startins);
+    break;
+  case BC_FORL: case BC_ITERL: case BC_ITRNL:  /* Loop end, jumps back. */
+    first = startpc + 1 + bc_j(T->startins);
+    last = startpc;
+    break;
+  default:
+    return 0;
+  }
+  return pc < first || pc > last;
+}
+
+/*
+** Check whether a root trace should be re-recorded instead of compiling
+** a side trace for its hot exit. The new root trace is recorded along the
+** path which is currently executed, so the hot path gets register allocation
+** and optimizations of the root trace rather than reloading everything from
+** the snapshot in the side trace. Only loops and functions without side
+** traces are re-recorded, at most JIT_P_retrace times per starting
+** instruction. Exits leaving the loop (e.g. the end of an inner loop) are
+** taken regardless of the recorded path and are never re-recorded.
+*/
+static int trace_retrace(jit_State *J, GCtrace *T, const BCIns *pc)
+{
+  uint32_t i;
+  switch (bc_op(T->startins)) {
+  case BC_FORL: case BC_LOOP: case BC_ITERL: case BC_ITRNL: case BC_FUNCF:
+    break;
+  default:
+    return 0;
+  }
+  if (T->root != 0 || T->nchild != 0 || J->param[JIT_P_retrace] == 0 ||
+      trace_isloopexit(T, pc))
+    return 0;
+  for (i = 0; i < J->nretrace; i++)
+    if (J->retrace[i].pc == T->startpc)  /* Cache slot found? */
+      break;
+  if (i == J->nretrace) {
+    if (i == RETRACE_SLOTS)
+      return 0;  /* No free slot, the count could not be kept. */
+    J->retrace[i].pc = T->startpc;
+    J->retrace[i].count = 0;
+    J->nretrace++;
+  }
+  if (J->retrace[i].count >= (uint32_t)J->param[JIT_P_retrace])
+    return 0;
+  J->retrace[i].count++;
+  lj_trace_flush(J, T->traceno);
+  /* Start recording as soon as the starting instruction is reached. */
+  uj_hotcnt_set_counter(T->startpc, 1);
+  return 1;
+}
+
 /* Check for a hot side exit. If yes, start recording a side trace. */
 static void trace_hotside(jit_State *J, const BCIns *pc) {
   GCtrace  *T    = traceref(J, J->parent);
@@ -665,6 +766,9 @@ static void trace_hotside(jit_State *J, const BCIns *pc) {
     return;
   }
   if (++snap->count >= J->param[JIT_P_hotexit]) {
+    if (trace_retrace(J, T, pc)) {
+      return;
+    }
     lua_assert(J->state == LJ_TRACE_IDLE);
     /* J->parent is non-zero for a side trace. */
     J->state = LJ_TRACE_START;
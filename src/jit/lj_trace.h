@@ -15,13 +15,6 @@
 #if LJ_HASJIT
 #include "jit/lj_jit.h"
 
-/* Trace errors. */
-typedef enum {
-#define TREDEF(name, msg)       LJ_TRERR_##name,
-#include "jit/lj_traceerr.h"
-  LJ_TRERR__MAX
-} TraceError;
-
 LJ_NORET void lj_trace_err(jit_State *J, TraceError e);
 LJ_NORET void lj_trace_err_info_func(jit_State *J, TraceError e);
 LJ_NORET void lj_trace_err_info_op(jit_State *J, TraceError e, int32_t op);
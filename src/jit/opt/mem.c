@@ -72,6 +72,30 @@ static AliasRet aa_table(jit_State *J, IRRef ta, IRRef tb)
   return aa_escape(J, taba, tabb);
 }
 
+/* Table clearing calls overwrite values of a table without any stores.
+** Returns the reference of the most recent clearing call above lim which
+** may affect table ta, or lim if there is none. The result limits the
+** search for stores and loads which can be forwarded or eliminated.
+*/
+static IRRef fwd_aa_tab_clear(jit_State *J, IRRef ta, IRRef lim)
+{
+  IRRef ref = J->chain[IR_CALLS];
+  while (ref > lim) {
+    IRIns *calls = IR(ref);
+    if (calls->op2 == IRCALL_lj_tab_clear &&
+        (ta == calls->op1 || aa_table(J, ta, calls->op1) != ALIAS_NO))
+      return ref;  /* Conflict. */
+    ref = calls->prev;
+  }
+  return lim;  /* No conflict. */
+}
+
+/* Table reference of an array or hash reference. */
+static LJ_AINLINE IRRef fwd_ahref_tab(jit_State *J, IRIns *xr)
+{
+  return (xr->o == IR_HREFK || xr->o == IR_AREF) ? IR(xr->op1)->op1 : xr->op1;
+}
+
 /* Alias analysis for array and hash access using key-based disambiguation. */
 static AliasRet aa_ahref(jit_State *J, IRIns *refa, IRIns *refb)
 {
@@ -133,12 +157,12 @@ static AliasRet aa_ahref(jit_State *J, IRIns *refa, IRIns *refb)
 static TRef fwd_ahload(jit_State *J, IRRef xref)
 {
   IRIns *xr = IR(xref);
-  IRRef lim = xref;  /* Search limit. */
+  IRRef lim = fwd_aa_tab_clear(J, fwd_ahref_tab(J, xr), xref);  /* Limit. */
   IRRef ref;
 
   /* Search for conflicting stores. */
   ref = J->chain[fins->o+IRDELTA_L2S];
-  while (ref > xref) {
+  while (ref > lim) {
     IRIns *store = IR(ref);
     switch (aa_ahref(J, xr, IR(store->op1))) {
     case ALIAS_NO:   break;  /* Continue searching. */
@@ -153,7 +177,8 @@ static TRef fwd_ahload(jit_State *J, IRRef xref)
     IRIns *ir = (xr->o == IR_HREFK || xr->o == IR_AREF) ? IR(xr->op1) : xr;
     IRRef tab = ir->op1;
     ir = IR(tab);
-    if (ir->o == IR_TNEW || (ir->o == IR_TDUP && irref_isk(xr->op2))) {
+    if ((ir->o == IR_TNEW || (ir->o == IR_TDUP && irref_isk(xr->op2))) &&
+        fwd_aa_tab_clear(J, tab, tab) == tab) {
       /* A NEWREF with a number key may end up pointing to the array part.
       ** But it's referenced from HSTORE and not found in the ASTORE chain.
       ** For now simply consider this a conflict without forwarding anything.
@@ -264,8 +289,9 @@ TRef lj_opt_fwd_hrefk(jit_State *J)
   while (ref > tab) {
     IRIns *newref = IR(ref);
     if (tab == newref->op1) {
-      if (fright->op1 == newref->op2)
-        return ref;  /* Forward from NEWREF. */
+      if (fright->op1 == newref->op2 &&
+          fwd_aa_tab_clear(J, tab, ref) == ref)
+        return ref;  /* Forward from NEWREF unless the table was cleared. */
       else
         goto docse;
     } else if (aa_table(J, tab, newref->op1) != ALIAS_NO) {
@@ -274,7 +300,7 @@ TRef lj_opt_fwd_hrefk(jit_State *J)
     ref = newref->prev;
   }
   /* No conflicting NEWREF: key location unchanged for HREFK of TDUP. */
-  if (IR(tab)->o == IR_TDUP)
+  if (IR(tab)->o == IR_TDUP && fwd_aa_tab_clear(J, tab, tab) == tab)
     fins->t.irt &= ~IRT_GUARD;  /* Drop HREFK guard. */
 docse:
   return CSEFOLD;
@@ -328,9 +354,10 @@ TRef lj_opt_dse_ahstore(jit_State *J)
   IRRef xref = fins->op1;  /* xREF reference. */
   IRRef val = fins->op2;  /* Stored value reference. */
   IRIns *xr = IR(xref);
+  IRRef lim = fwd_aa_tab_clear(J, fwd_ahref_tab(J, xr), xref);  /* Limit. */
   IRRef1 *refp = &J->chain[fins->o];
   IRRef ref = *refp;
-  while (ref > xref) {  /* Search for redundant or conflicting stores. */
+  while (ref > lim) {  /* Search for redundant or conflicting stores. */
     IRIns *store = IR(ref);
     switch (aa_ahref(J, xr, IR(store->op1))) {
     case ALIAS_NO:
@@ -844,6 +871,9 @@ TRef lj_opt_fwd_tab_len(jit_State *J)
   /* Any ASTORE is a conflict and limits the search. */
   if (J->chain[IR_ASTORE] > lim) lim = J->chain[IR_ASTORE];
 
+  /* So does clearing of the table. */
+  lim = fwd_aa_tab_clear(J, tab, lim);
+
   /* Search for conflicting HSTORE with numeric key. */
   ref = J->chain[IR_HSTORE];
   while (ref > lim) {
@@ -876,9 +906,11 @@ TRef lj_opt_fwd_tab_len(jit_State *J)
 */
 int lj_opt_fwd_wasnonnil(jit_State *J, IROpT loadop, IRRef xref)
 {
+  /* Nothing can be derived from before clearing of the table. */
+  IRRef lim = fwd_aa_tab_clear(J, fwd_ahref_tab(J, IR(xref)), xref);
   /* First check stores. */
   IRRef ref = J->chain[loadop+IRDELTA_L2S];
-  while (ref > xref) {
+  while (ref > lim) {
     IRIns *store = IR(ref);
     if (store->op1 == xref) {  /* Same xREF. */
       /* A nil store MAY alias, but a non-nil store MUST alias. */
@@ -898,7 +930,7 @@ int lj_opt_fwd_wasnonnil(jit_State *J, IROpT loadop, IRRef xref)
 
   /* Check loads since nothing could be derived from stores. */
   ref = J->chain[loadop];
-  while (ref > xref) {
+  while (ref > lim) {
     IRIns *load = IR(ref);
     if (load->op1 == xref) {  /* Same xREF. */
       /* A nil load MAY alias, but a non-nil load MUST alias. */
@@ -26,8 +26,8 @@ static LJ_AINLINE int movtv_is_tget(const BCIns *ins)
 {
 	BCOp op = bc_op(*ins);
 
-	return op == BC_TGETV || op == BC_TGETS || op == BC_TGETB ||
-	       op == BC_GGET;
+	return op == BC_TGETV || op == BC_TGETS || op == BC_TGETSS ||
+	       op == BC_TGETB || op == BC_GGET;
 }
 
 static LJ_AINLINE int movtv_is_tset(const BCIns *ins)
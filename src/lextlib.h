@@ -26,6 +26,8 @@ struct luae_Options {
 	void            *allocud;
 	enum luae_HashF  hashftype;
 	int              disableitern;
+	int              enablebcopt;
+	int              enablesuperins;
 };
 
 /* Extended thread statuses; the 5th bit must be set to 1. */
@@ -53,6 +55,8 @@ struct luae_Metrics {
 	size_t jit_snap_restore;
 	size_t jit_mcode_size;
 	unsigned int jit_trace_num;
+	size_t jit_compile_ns;
+	size_t jit_compile_ns_max;
 };
 
 /* Returns a string describing current uJIT version. */
@@ -71,6 +75,25 @@ LUAEXT_API void         luaE_seal(lua_State *L, int idx);
 
 LUAEXT_API lua_State   *luaE_createstate(const struct luae_Options *opt);
 
+/*
+ * Data state images. The data root of the data state L (see
+ * luaE_setdataroot) is written to out, which can be loaded later by another
+ * process with luaE_loaddatastate instead of building the data once again.
+ * The data root may contain only booleans, numbers, strings, tables and Lua
+ * functions without upvalues. Returns 0 on success and non-0 otherwise.
+ */
+LUAEXT_API int luaE_savedataroot(lua_State *L, FILE *out);
+
+/*
+ * Creates a new state with the options specified in opt (opt->datastate must
+ * be NULL), loads the data root from the image in (which must be a regular
+ * file containing the image only), sets and seals it. The returned state is
+ * ready to be used as a data state. Returns NULL on failure. NB! Functions
+ * are stored as bytecode, so images must come from a trusted source.
+ */
+LUAEXT_API lua_State *luaE_loaddatastate(const struct luae_Options *opt,
+					 FILE *in);
+
 /* Makes the value stored at index idx immutable in-place. */
 LUAEXT_API void luaE_immutable(lua_State *L, int idx);
 
@@ -118,6 +141,13 @@ LUAEXT_API void luaE_dumpbc(lua_State *L, int idx, FILE *out);
 LUAEXT_API void luaE_dumpbcsource(lua_State *L, int idx, FILE *out,
 				  int hl_bc_pos);
 
+/*
+ * Runs a full GC cycle and writes a binary snapshot of all live objects and
+ * references between them to out. The snapshot can be analyzed with
+ * ujit-parse-heapdump.
+ */
+LUAEXT_API void luaE_dumpheap(lua_State *L, FILE *out);
+
 /* Table public API. */
 
 /*
@@ -161,6 +191,21 @@ LUAEXT_API void luaE_tabletoset(lua_State *L, int idx);
  */
 LUAEXT_API void luaE_deepcopytable(lua_State *to, lua_State *from, int idx);
 
+/*
+ * Serializes the value at `idx` into a compact binary string and pushes it on
+ * the top of the stack. The value may contain only nil, booleans, numbers,
+ * strings and tables, shared references and cycles are preserved, metatables
+ * are not serialized. Throws on unsupported values.
+ */
+LUAEXT_API void luaE_serialize(lua_State *L, int idx);
+
+/*
+ * Deserializes a value from `buf` of size `len` produced by luaE_serialize
+ * (possibly in another state or process) and pushes it on the top of the
+ * stack. Throws if the data is malformed.
+ */
+LUAEXT_API void luaE_deserialize(lua_State *L, const char *buf, size_t len);
+
 /* Coverage public API. */
 
 #define LUAE_COV_SUCCESS 0
@@ -181,11 +226,16 @@ LUAEXT_API int luaE_coveragestop(lua_State *L);
 #define LUAE_INT_SUCCESS 0
 #define LUAE_INT_ERR     1
 
+/* Pseudo signal number for luaE_intinit: Count ticks in a dedicated thread. */
+#define LUAE_INT_THREAD  0
+
 /*
  * Global initialisation of timer interrupts. Singal with the number signo will
- * be used to deliver interrupts to the process. This function must be called
- * prior to usage of any facilities provided by the API for coroutine timeouts.
- * Returns LUAE_INT_SUCCESS on success, LUAE_INT_ERR otherwise.
+ * be used to deliver interrupts to the process. If signo is LUAE_INT_THREAD,
+ * no signals are sent, a dedicated thread updates ticks instead. This function
+ * must be called prior to usage of any facilities provided by the API for
+ * coroutine timeouts. Returns LUAE_INT_SUCCESS on success, LUAE_INT_ERR
+ * otherwise.
  */
 LUAEXT_API int luaE_intinit(int signo);
 
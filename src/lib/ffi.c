@@ -21,6 +21,7 @@
 #include "uj_err.h"
 #include "uj_throw.h"
 #include "uj_str.h"
+#include "uj_sbuf.h"
 #include "lj_tab.h"
 #include "uj_meta.h"
 #include "uj_mtab.h"
@@ -492,6 +493,23 @@ LJLIB_CF(ffi_cdef)
   return 0;
 }
 
+LJLIB_CF(ffi_savetypes)
+{
+  struct sbuf *sb = uj_sbuf_reset_tmp(L);
+  lj_ctype_save(ctype_cts(L), sb);
+  setstrV(L, L->top++, uj_str_frombuf(L, sb));
+  lj_gc_check(L);
+  return 1;
+}
+
+LJLIB_CF(ffi_loadtypes)
+{
+  GCstr *s = uj_lib_checkstr(L, 1);
+  lj_ctype_load(ctype_cts(L), (const uint8_t *)strdata(s), s->len);
+  lj_gc_check(L);
+  return 0;
+}
+
 LJLIB_CF(ffi_new)       LJLIB_REC(.)
 {
   CTState *cts = ctype_cts(L);
@@ -251,6 +251,10 @@ static uint32_t jit_cpudetect(void)
     flags |= JIT_F_CMOV;
   }
 
+  if (cpuinfo_has_bmi2()) {
+    flags |= JIT_F_BMI2;
+  }
+
   return flags;
 }
 #endif /* LJ_HASJIT */
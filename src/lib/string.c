@@ -807,6 +807,23 @@ static GCstr *meta_tostring(lua_State *L, unsigned int arg)
 
 /* Maximum size of each formatted item (> len(format('%99.99f', -1e308))). */
 #define MAX_FMTITEM 512
+/*
+** Returns precision of "%g" and "%.<digits>g" formats, which are printed
+** without the libc machinery, or -1 for all other forms.
+*/
+static int format_gprec(const char *form)
+{
+  const char *p = form + 1;
+  int prec = 0;
+  if (*p == 'g')
+    return 6;
+  if (*p++ != '.' || !lj_char_isdigit(uchar(*p)))
+    return -1;
+  while (lj_char_isdigit(uchar(*p)))
+    prec = prec * 10 + (*p++ - '0');
+  return *p == 'g' ? prec : -1;
+}
+
 #define push_formatted(sb, format, arg) \
   do { \
     int pushed; \
@@ -816,14 +833,15 @@ static GCstr *meta_tostring(lua_State *L, unsigned int arg)
     (sb)->sz += pushed; \
   } while(0)
 
-LJLIB_CF(string_format)         LJLIB_REC(.)
+/* Format arguments following the format string at `arg` and append them to
+** the buffer. Shared with ujit.string.buffer objects.
+*/
+void lj_string_format(lua_State *L, struct sbuf *sb, unsigned int arg)
 {
-  unsigned int arg = 1;
   const unsigned int top = L->top - L->base;
   GCstr *strfmt = uj_lib_checkstr(L, arg);
   const char *fmt = strdata(strfmt);
   const char *fmt_end = fmt + strfmt->len;
-  struct sbuf *sb = uj_sbuf_reset_tmp(L);
 
   while (fmt < fmt_end) {
     /*
@@ -861,12 +879,12 @@ LJLIB_CF(string_format)         LJLIB_REC(.)
       break;
     }
     case 'd':  case 'i': {
-      LUA_INTFRM_T i = uj_lib_checknum(L, arg);
-      if ((i == (int32_t)i) && is_simple_format) {
-        uj_sbuf_push_int(sb, i);
+      lua_Number n = uj_lib_checknum(L, arg);
+      if (is_simple_format) {
+        uj_sbuf_push_numint(sb, n);
       } else {
         addintlen(form);
-        push_formatted(sb, form, i);
+        push_formatted(sb, form, (LUA_INTFRM_T)n);
       }
       break;
     }
@@ -877,7 +895,13 @@ LJLIB_CF(string_format)         LJLIB_REC(.)
     case 'e':  case 'E': case 'f': case 'g': case 'G': case 'a': case 'A': {
       lua_Number n = uj_lib_checknum(L, arg);
       if (LJ_LIKELY(lj_fp_finite(n))) {
-        push_formatted(sb, form, n);
+        int prec = fmt[-1] == 'g' ? format_gprec(form) : -1;
+        if (prec > 0) {
+          uj_sbuf_reserve(sb, uj_sbuf_size(sb) + MAX_FMTITEM);
+          sb->sz += uj_cstr_fromnumg(uj_sbuf_back(sb), n, prec);
+        } else {
+          push_formatted(sb, form, n);
+        }
       } else {
         /* Canonicalize output of non-finite values. */
         char *p, nbuf[UJ_CSTR_NUMBUF];
@@ -924,6 +948,12 @@ LJLIB_CF(string_format)         LJLIB_REC(.)
       break;
     }
   }
+}
+
+LJLIB_CF(string_format)         LJLIB_REC(.)
+{
+  struct sbuf *sb = uj_sbuf_reset_tmp(L);
+  lj_string_format(L, sb, 1);
   setstrV(L, L->top, uj_str_frombuf(L, sb));
   uj_state_stack_incr_top(L);
   lj_gc_check(L);
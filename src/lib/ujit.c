@@ -9,6 +9,7 @@
 #include <unistd.h>
 
 #include "lua.h"
+#include "lauxlib.h"
 #include "lextlib.h"
 
 #include "uj_lib.h"
@@ -17,6 +18,7 @@
 #include "lj_tab.h"
 #include "uj_str.h"
 #include "uj_sbuf.h"
+#include "uj_strbuf.h"
 #include "lj_obj.h"
 #include "uj_dispatch.h"
 #include "uj_vmstate.h"
@@ -27,6 +29,7 @@
 #include "uj_ff.h"
 #include "lj_gc.h"
 #include "uj_state.h"
+#include "uj_func.h"
 #include "uj_coverage.h"
 #include "utils/lj_char.h"
 
@@ -48,7 +51,7 @@ LJLIB_CF(ujit_getmetrics)
 	struct luae_Metrics m_raw = luaE_metrics(L);
 	struct GCtab *m;
 
-	lua_createtable(L, 0, 16);
+	lua_createtable(L, 0, 18);
 	m = tabV(L->top - 1);
 
 	setnumfield(L, m, "strnum", m_raw.strnum);
@@ -69,6 +72,8 @@ LJLIB_CF(ujit_getmetrics)
 	setnumfield(L, m, "gc_steps_finalize", m_raw.gc_steps_finalize);
 
 	setnumfield(L, m, "jit_snap_restore", m_raw.jit_snap_restore);
+	setnumfield(L, m, "jit_compile_ns", m_raw.jit_compile_ns);
+	setnumfield(L, m, "jit_compile_ns_max", m_raw.jit_compile_ns_max);
 
 	setnumfield(L, m, "strhash_hit", m_raw.strhash_hit);
 	setnumfield(L, m, "strhash_miss", m_raw.strhash_miss);
@@ -142,6 +147,9 @@ static const char *fname_vmsuffix(struct lua_State *L, unsigned int narg)
 
 #include "dump/uj_dump_iface.h"
 #include "dump/uj_dump_utils.h"
+#if LJ_HASJIT
+#include "uj_perfjit.h"
+#endif /* LJ_HASJIT */
 
 static LJ_AINLINE int isnonnegnum(lua_Number num)
 {
@@ -186,6 +194,15 @@ LJLIB_CF(ujit_dump_stack)
 	return 0;
 }
 
+/* ujit.dump.heap(io_object) */
+LJLIB_CF(ujit_dump_heap)
+{
+	struct IOFileUD *iof = uddata(uj_lib_checkiofile(L, 1));
+
+	uj_dump_heap(iof->fp, L);
+	return 0;
+}
+
 /* ujit.dump.bc(io_object, func) */
 LJLIB_CF(ujit_dump_bc)
 {
@@ -250,6 +267,38 @@ LJLIB_CF(ujit_dump_trace)
 	return 0;
 }
 
+/* ujit.dump.exits(io_object, trace_no) */
+LJLIB_CF(ujit_dump_exits)
+{
+#if LJ_HASJIT
+	struct IOFileUD *iof = uddata(uj_lib_checkiofile(L, 1));
+	const struct GCtrace *trace = get_trace_object(L, 2);
+
+	if (trace == NULL)
+		return 0;
+
+	uj_dump_exits(iof->fp, trace);
+#else
+	UNUSED(L);
+#endif /* LJ_HASJIT */
+
+	return 0;
+}
+
+/* ujit.dump.aborts(io_object) */
+LJLIB_CF(ujit_dump_aborts)
+{
+#if LJ_HASJIT
+	struct IOFileUD *iof = uddata(uj_lib_checkiofile(L, 1));
+
+	uj_dump_aborts(iof->fp, L2J(L));
+#else
+	UNUSED(L);
+#endif /* LJ_HASJIT */
+
+	return 0;
+}
+
 /* ujit.dump.mcode(io_object, trace_no) */
 LJLIB_CF(ujit_dump_mcode)
 {
@@ -323,6 +372,46 @@ LJLIB_CF(ujit_dump_stop)
 	return 1;
 }
 
+/*
+ * local started, fname = ujit.dump.perfstart([format])
+ * format is either "map" (default) or "jitdump". Information about compiled
+ * traces is emitted to fname, which is returned to the caller.
+ */
+LJLIB_CF(ujit_dump_perfstart)
+{
+#if LJ_HASJIT
+	/* ORDER PERFJIT_FORMAT_ */
+	int format = uj_lib_checkopt(L, 1, PERFJIT_FORMAT_MAP,
+				     "\3map\7jitdump");
+	char fname[PERFJIT_FNAME_SIZE];
+
+	if (uj_perfjit_start(L, (enum perfjit_format)format, fname) == 0) {
+		lua_pushboolean(L, 1);
+		lua_pushstring(L, fname);
+	} else {
+		lua_pushboolean(L, 0);
+		lua_pushnil(L);
+	}
+#else
+	lua_pushboolean(L, 0);
+	lua_pushnil(L);
+#endif /* LJ_HASJIT */
+
+	return 2;
+}
+
+/* local stopped = ujit.dump.perfstop() */
+LJLIB_CF(ujit_dump_perfstop)
+{
+#if LJ_HASJIT
+	lua_pushboolean(L, uj_perfjit_stop(L2J(L)) == 0 ? 1 : 0);
+#else
+	lua_pushboolean(L, 0);
+#endif /* LJ_HASJIT */
+
+	return 1;
+}
+
 /* ------------------------------------------------------------------------ */
 
 #include "lj_libdef.h"
@@ -363,6 +452,34 @@ LJLIB_CF(ujit_table_toset) LJLIB_REC(.)
 	return 1;
 }
 
+/*
+ * local t = ujit.table.new(narr, nhash) -- preallocates array and hash parts
+ */
+LJLIB_CF(ujit_table_new) LJLIB_REC(.)
+{
+	int32_t a = uj_lib_checkint(L, 1);
+	int32_t h = uj_lib_checkint(L, 2);
+
+	lj_gc_check(L);
+	settabV(L, L->top, lj_tab_new_ah(L, a, h));
+	uj_state_stack_incr_top(L);
+	return 1;
+}
+
+/*
+ * ujit.table.clear(t) -- removes all elements of t keeping allocated memory
+ */
+LJLIB_CF(ujit_table_clear) LJLIB_REC(.)
+{
+	GCtab *t = uj_lib_checktab(L, 1);
+
+	if (uj_obj_is_immutable(obj2gco(t)))
+		uj_err(L, UJ_ERR_IMMUT_MODIF);
+
+	lj_tab_clear(t);
+	return 0;
+}
+
 LJLIB_CF(ujit_table_size) LJLIB_REC(.)
 {
 	const GCtab *t = uj_lib_checktab(L, 1);
@@ -418,6 +535,29 @@ out:
 	return 1;
 }
 
+/*
+ * local s = ujit.table.encode(value) -- serializes value to a binary string
+ */
+LJLIB_CF(ujit_table_encode)
+{
+	uj_lib_checkany(L, 1);
+	luaE_serialize(L, 1);
+
+	return 1;
+}
+
+/*
+ * local value = ujit.table.decode(s) -- restores a value encoded with encode
+ */
+LJLIB_CF(ujit_table_decode)
+{
+	const GCstr *s = uj_lib_checkstr(L, 1);
+
+	luaE_deserialize(L, strdata(s), s->len);
+
+	return 1;
+}
+
 /* ------------------------------------------------------------------------ */
 
 #include "lj_libdef.h"
@@ -637,6 +777,30 @@ LJLIB_CF(ujit_memprof_start)
 	return 2;
 }
 
+/* local started = ujit.memprof.sample(rate) */
+LJLIB_CF(ujit_memprof_sample)
+{
+	struct memprof_options opt = {0};
+	const lua_Number rate = uj_lib_checknum(L, 1);
+
+	if (!(rate >= 1))
+		uj_err_arg(L, UJ_ERR_BADVAL, 1);
+
+	opt.sample_rate = (uint64_t)rate;
+	lua_pushboolean(L, uj_memprof_start(L, &opt) == LUAE_PROFILE_SUCCESS);
+	return 1;
+}
+
+/* local reported = ujit.memprof.report(io_object) */
+LJLIB_CF(ujit_memprof_report)
+{
+	struct IOFileUD *iof = uddata(uj_lib_checkiofile(L, 1));
+
+	lua_pushboolean(L, uj_memprof_report(L, iof->fp) ==
+				   LUAE_PROFILE_SUCCESS);
+	return 1;
+}
+
 /* local stopped = ujit.memprof.stop() */
 LJLIB_CF(ujit_memprof_stop)
 {
@@ -648,10 +812,14 @@ LJLIB_CF(ujit_memprof_stop)
 
 /* ----- ujit.coverage module --------------------------------------------- */
 
-#define LJLIB_MODULE_ujit_coverage
+/*
+ * Coverage functions are never hot and are registered as plain C functions:
+ * fast function ids are limited to 8 bits and are kept for builtins which
+ * are worth compiling.
+ */
 
 /* local started = ujit.coverage.start(filename[, excludes]) */
-LJLIB_CF(ujit_coverage_start)
+static int ujit_coverage_start(lua_State *L)
 {
 	size_t exclude_size;
 	const char **excludes;
@@ -680,27 +848,33 @@ LJLIB_CF(ujit_coverage_start)
 }
 
 /* ujit.coverage.stop() */
-LJLIB_CF(ujit_coverage_stop)
+static int ujit_coverage_stop(lua_State *L)
 {
 	uj_coverage_stop(L);
 	return 0;
 }
 
 /* ujit.coverage.pause() */
-LJLIB_CF(ujit_coverage_pause)
+static int ujit_coverage_pause(lua_State *L)
 {
 	uj_coverage_pause(L);
 	return 0;
 }
 
 /* ujit.coverage.unpause() */
-LJLIB_CF(ujit_coverage_unpause)
+static int ujit_coverage_unpause(lua_State *L)
 {
 	uj_coverage_unpause(L);
 	return 0;
 }
 
-#include "lj_libdef.h"
+static const luaL_Reg ujit_coverage_lib[] = {
+	{"start", ujit_coverage_start},
+	{"stop", ujit_coverage_stop},
+	{"pause", ujit_coverage_pause},
+	{"unpause", ujit_coverage_unpause},
+	{NULL, NULL}
+};
 
 /* ----- ujit.iprof module ------------------------------------------------ */
 
@@ -898,6 +1072,104 @@ LJLIB_CF(ujit_debug_gettableinfo)
 
 #include "lj_libdef.h"
 
+/* ----- ujit.string.buffer methods ----------------------------------------- */
+
+#define LJLIB_MODULE_ujit_strbuf
+
+static struct sbuf *strbuf_check(lua_State *L)
+{
+	return uj_strbuf_sbuf(uj_lib_checkstrbuf(L, 1));
+}
+
+/*
+ * buf:put(...) -- appends strings and numbers to the buffer, returns buf
+ */
+LJLIB_CF(ujit_strbuf_put) LJLIB_REC(.)
+{
+	struct sbuf *sb = strbuf_check(L);
+	const unsigned int top = (unsigned int)(L->top - L->base);
+	unsigned int narg;
+
+	for (narg = 2; narg <= top; narg++) {
+		const TValue *tv = uj_lib_narg2tv(L, narg);
+
+		if (tvisstr(tv))
+			uj_strbuf_put_str(L, sb, strV(tv));
+		else if (tvisnum(tv))
+			uj_strbuf_put_number(L, sb, numV(tv));
+		else
+			uj_err_argt(L, narg, LUA_TSTRING);
+	}
+
+	L->top = L->base + 1;
+	return 1;
+}
+
+/*
+ * buf:putf(fmt, ...) -- appends string.format(fmt, ...) to the buffer,
+ * returns buf
+ */
+LJLIB_CF(ujit_strbuf_putf) LJLIB_REC(.)
+{
+	struct sbuf *sb = strbuf_check(L);
+
+	sb->L = L;
+	lj_string_format(L, sb, 2);
+
+	L->top = L->base + 1;
+	return 1;
+}
+
+/*
+ * buf:reset() -- empties the buffer keeping allocated memory, returns buf
+ */
+LJLIB_CF(ujit_strbuf_reset) LJLIB_REC(.)
+{
+	uj_strbuf_reset(strbuf_check(L));
+
+	L->top = L->base + 1;
+	return 1;
+}
+
+static int strbuf_tostring(lua_State *L)
+{
+	const struct sbuf *sb = strbuf_check(L);
+
+	setstrV(L, L->top, uj_str_frombuf(L, sb));
+	uj_state_stack_incr_top(L);
+	lj_gc_check(L);
+	return 1;
+}
+
+/*
+ * local s = buf:tostring() -- interns the content of the buffer
+ */
+LJLIB_CF(ujit_strbuf_tostring) LJLIB_REC(.)
+{
+	return strbuf_tostring(L);
+}
+
+LJLIB_CF(ujit_strbuf___tostring)
+{
+	return strbuf_tostring(L);
+}
+
+LJLIB_CF(ujit_strbuf___len)
+{
+	lua_pushinteger(L, uj_sbuf_size(strbuf_check(L)));
+	return 1;
+}
+
+LJLIB_CF(ujit_strbuf___gc)
+{
+	uj_strbuf_free(L, uj_lib_checkstrbuf(L, 1));
+	return 0;
+}
+
+LJLIB_PUSH(top-1) LJLIB_SET(__index)
+
+#include "lj_libdef.h"
+
 /* ----- ujit.string module ------------------------------------------------- */
 
 #define LJLIB_MODULE_ujit_string
@@ -913,7 +1185,37 @@ LJLIB_CF(ujit_string_trim) LJLIB_REC(.)
 	return 1;
 }
 
-LJLIB_NOREG LJLIB_CF(ujit_string_split_aux)
+LJLIB_CF(ujit_string_startswith) LJLIB_REC(.)
+{
+	GCstr *s = uj_lib_checkstr(L, 1);
+	GCstr *prefix = uj_lib_checkstr(L, 2);
+
+	setboolV(L->top - 1, uj_str_startswith(s, prefix));
+	return 1;
+}
+
+LJLIB_CF(ujit_string_endswith) LJLIB_REC(.)
+{
+	GCstr *s = uj_lib_checkstr(L, 1);
+	GCstr *suffix = uj_lib_checkstr(L, 2);
+
+	setboolV(L->top - 1, uj_str_endswith(s, suffix));
+	return 1;
+}
+
+LJLIB_CF(ujit_string_count) LJLIB_REC(.)
+{
+	GCstr *s = uj_lib_checkstr(L, 1);
+	GCstr *sub = uj_lib_checkstr(L, 2);
+
+	if (sub->len == 0)
+		uj_err_arg(L, UJ_ERR_COUNT_EMPTY_SUBSTRING, 2);
+
+	setnumV(L->top - 1, (lua_Number)uj_str_count(s, sub));
+	return 1;
+}
+
+LJLIB_NOREG LJLIB_CF(ujit_string_split_aux) LJLIB_REC(.)
 {
 	size_t i, j;
 	const char *find_res = NULL;
@@ -956,7 +1258,28 @@ LJLIB_NOREG LJLIB_CF(ujit_string_split_aux)
 	return 1;
 }
 
-LJLIB_CF(ujit_string_split)
+/*
+ * Creates an iterator closure over tokens of a string separated by sep.
+ * Doesn't touch the stack, so it is called from compiled code, too.
+ */
+GCfunc *lj_ujit_string_splitter(lua_State *L, GCstr *sep)
+{
+	GCfunc *fn = uj_func_newC(L, 2, L->env);
+
+	fn->c.f = lj_cf_ujit_string_split_aux;
+	fn->c.ffid = FF_ujit_string_split_aux;
+	fn->c.pc = &G(L)->bc_cfunc_int;
+
+	/* separator, 1st upvalue */
+	setstrV(L, &fn->c.upvalue[0], sep);
+
+	/* control variable, 2nd upvalue */
+	setrawV(&fn->c.upvalue[1], 0);
+
+	return fn;
+}
+
+LJLIB_CF(ujit_string_split) LJLIB_REC(.)
 {
 	GCstr *str = uj_lib_checkstr(L, 1);
 	GCstr *sep = uj_lib_checkstr(L, 2);
@@ -964,18 +1287,12 @@ LJLIB_CF(ujit_string_split)
 	if (sep->len == 0)
 		uj_err_arg(L, UJ_ERR_SPLIT_EMPTY_SEPARATOR, 2);
 
-	/* separator, 1st upvalue */
-	setstrV(L, L->top, sep);
-	uj_state_stack_incr_top(L);
+	lj_gc_check(L);
 
-	/* control variable, 2nd upvalue */
-	setrawV(L->top, 0);
+	/* push splitter closure on stack */
+	setfuncV(L, L->top, lj_ujit_string_splitter(L, sep));
 	uj_state_stack_incr_top(L);
 
-	/* push closure on stack */
-	uj_lib_pushcc(L, lj_cf_ujit_string_split_aux, FF_ujit_string_split_aux,
-		      2);
-
 	/* push input string on stack */
 	setstrV(L, L->top, str);
 	uj_state_stack_incr_top(L);
@@ -984,6 +1301,23 @@ LJLIB_CF(ujit_string_split)
 	return 2;
 }
 
+LJLIB_PUSH(top-2) LJLIB_SET(!)  /* Set environment to buffer metatable. */
+
+/*
+ * local buf = ujit.string.buffer() -- creates an empty string buffer
+ */
+LJLIB_CF(ujit_string_buffer)
+{
+	struct sbuf *sb = (struct sbuf *)lua_newuserdata(L, sizeof(*sb));
+	GCudata *ud = udataV(L->top - 1);
+
+	ud->udtype = UDTYPE_STR_BUF;
+	/* NOBARRIER: The GCudata is new (marked white). */
+	ud->metatable = curr_func(L)->c.env;
+	uj_sbuf_init(L, sb);
+	return 1;
+}
+
 #include "lj_libdef.h"
 
 LUALIB_API int luaopen_ujit(struct lua_State *L)
@@ -993,10 +1327,11 @@ LUALIB_API int luaopen_ujit(struct lua_State *L)
 	LJ_LIB_REG(L, "ujit.memprof", ujit_memprof);
 	LJ_LIB_REG(L, "ujit.dump", ujit_dump);
 	LJ_LIB_REG(L, "ujit.table", ujit_table);
-	LJ_LIB_REG(L, "ujit.coverage", ujit_coverage);
+	luaL_register(L, "ujit.coverage", ujit_coverage_lib);
 	LJ_LIB_REG(L, "ujit.iprof", ujit_iprof);
 	LJ_LIB_REG(L, "ujit.math", ujit_math);
 	LJ_LIB_REG(L, "ujit.debug", ujit_debug);
+	LJ_LIB_REG(L, NULL, ujit_strbuf);
 	LJ_LIB_REG(L, "ujit.string", ujit_string);
 	return 1;
 }
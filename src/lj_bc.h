@@ -175,15 +175,18 @@ LJ_DATA const ASMFunction lj_bc_ptr[];
   \
   /* 0x4f */ _(JMP,     rbase,  ___,    jump,   ___) \
   \
+  /* Superinstructions. Never written to bytecode dumps. */ \
+  /* 0x50 */ _(TGETSS,  dst,    var,    str,    index) \
+  \
   /* Function headers. I/J = interp/JIT, F/V/C = fixarg/vararg/C func. */ \
-  /* 0x50 */ _(FUNCF,   rbase,  ___,    ___,    ___) \
-  /* 0x51 */ _(IFUNCF,  rbase,  ___,    ___,    ___) \
-  /* 0x52 */ _(JFUNCF,  rbase,  ___,    lit,    ___) \
-  /* 0x53 */ _(FUNCV,   rbase,  ___,    ___,    ___) \
-  /* 0x54 */ _(IFUNCV,  rbase,  ___,    ___,    ___) \
-  /* 0x55 */ _(JFUNCV,  rbase,  ___,    lit,    ___) \
-  /* 0x56 */ _(FUNCC,   rbase,  ___,    ___,    ___) \
-  /* 0x57 */ _(FUNCCW,  rbase,  ___,    ___,    ___)
+  /* 0x51 */ _(FUNCF,   rbase,  ___,    ___,    ___) \
+  /* 0x52 */ _(IFUNCF,  rbase,  ___,    ___,    ___) \
+  /* 0x53 */ _(JFUNCF,  rbase,  ___,    lit,    ___) \
+  /* 0x54 */ _(FUNCV,   rbase,  ___,    ___,    ___) \
+  /* 0x55 */ _(IFUNCV,  rbase,  ___,    ___,    ___) \
+  /* 0x56 */ _(JFUNCV,  rbase,  ___,    lit,    ___) \
+  /* 0x57 */ _(FUNCC,   rbase,  ___,    ___,    ___) \
+  /* 0x58 */ _(FUNCCW,  rbase,  ___,    ___,    ___)
 
 /* Bytecode opcode numbers. */
 typedef enum {
@@ -194,6 +194,7 @@ const char *lj_debug_slotname(GCproto *pt, const BCIns *ip, BCReg slot,
     *name = strdata(gco2str(proto_kgc(pt, ~(ptrdiff_t)bc_d(ins))));
     return "global";
   case BC_TGETS:
+  case BC_TGETSS:
     *name = strdata(gco2str(proto_kgc(pt, ~(ptrdiff_t)bc_c(ins))));
     if (def > proto_bc(pt)) {
       BCIns insp = def[-1];
@@ -31,6 +31,7 @@
 #define LJ_MAX_ABITS    28              /* Max. bits of array key. */
 #define LJ_MAX_ASIZE    ((1<<(LJ_MAX_ABITS-1))+1)  /* Max. array part size. */
 #define LJ_MAX_COLOSIZE 16              /* Max. elems for colocated array. */
+#define LJ_MAX_HCOLOBITS 3              /* Max. hash bits for colocated hash. */
 
 #define LJ_MAX_LINE     LJ_MAX_MEM      /* Max. source code line number. */
 #define LJ_MAX_XLEVEL   200             /* Max. syntactic nesting level. */
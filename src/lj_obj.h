@@ -220,6 +220,7 @@ enum {
   UDTYPE_USERDATA,      /* Regular userdata. */
   UDTYPE_IO_FILE,       /* I/O library FILE. */
   UDTYPE_FFI_CLIB,      /* FFI C library namespace. */
+  UDTYPE_STR_BUF,       /* ujit.string.buffer object. */
   UDTYPE__MAX
 };
 
@@ -381,7 +382,7 @@ struct GCtab {
   GCHeader;
   uint8_t  nomm;       /* Negative cache for fast metamethods. */
   int8_t   colo;       /* Array colocation. */
-  uint32_t unused;     /* Unused 32-bit padding. */
+  uint32_t hcolo;      /* Size of colocated hash part (or 0). */
   TValue   *array;     /* Array part. */
   GCtab    *metatable; /* Must be at same offset in GCudata. */
   GCobj    *gclist;
@@ -530,6 +531,22 @@ struct argbuf { /* auxiliary buffer for passing array of TValues around */
 };
 #endif /* LJ_HASJIT */
 
+/* Number of entries in the cache of __index resolutions, power of 2. */
+#define META_ICACHE_SIZE 256
+
+/*
+** Entry of the cache of __index resolutions, see uj_meta.c. Pointers here
+** are not GC roots: an entry is always validated against live objects
+** before use.
+*/
+struct meta_icache_entry {
+  const GCtab *mt;      /* Metatable the resolution starts from. */
+  const GCstr *key;     /* Resolved key. */
+  const GCtab *index;   /* Table stored at mt.__index. */
+  uint32_t mtslot;      /* Node of __index in the hash part of mt. */
+  uint32_t slot;        /* Node of key in the hash part of index. */
+};
+
 /* Global state, shared by all threads of a Lua universe. */
 typedef struct global_State {
   strhash_f hashf;
@@ -594,6 +611,9 @@ typedef struct global_State {
   GCstr *iprof_keys[IPROF_KEY_MAX];
 #endif /* UJIT_IPROF_ENABLED */
   int enable_itern;     /* Enables ISNEXT/ITERN generation in frontend */
+  int enable_bcopt;     /* Enables post-parse bytecode optimization */
+  int enable_superins;  /* Enables fused instructions generation in frontend */
+  struct meta_icache_entry meta_icache[META_ICACHE_SIZE]; /* __index cache. */
 } global_State;
 
 static LJ_AINLINE lua_State* gl_datastate(global_State *g) {
@@ -761,6 +781,7 @@ static LJ_AINLINE int uj_obj_is_immutable(const GCobj *o)
 
 #define tvisbool(o)     (tvisfalse(o) || tvistrue(o))
 #define tvislibiofile(o) (tvisudata((o)) && udataV((o))->udtype == UDTYPE_IO_FILE)
+#define tvisstrbuf(o)   (tvisudata((o)) && udataV((o))->udtype == UDTYPE_STR_BUF)
 
 #define tvislightud(o)  (gettag(o) == LJ_TLIGHTUD)
 #define tvisstr(o)      (gettag(o) == LJ_TSTR)
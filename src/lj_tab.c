@@ -135,22 +135,48 @@ static LJ_AINLINE void tab_hpart_free(global_State *g, Node *hpart, size_t size)
   uj_mem_free(MEM_G(g), hpart, size * sizeof(Node));
 }
 
+/* Small hash parts are colocated with the table object right after the
+** (possibly colocated) array part. This saves an allocation and keeps
+** fields of record-like tables next to the header. The space stays
+** reserved for the lifetime of the object, even if the hash part is
+** reallocated later.
+*/
+static LJ_AINLINE Node *tab_hcolo_node(const GCtab *t) {
+  return (Node *)((char *)t + sizetabcolo((uint32_t)t->colo & 0x7f));
+}
+
+static LJ_AINLINE int tab_hpart_iscolo(const GCtab *t) {
+  return t->hcolo != 0 && t->node == tab_hcolo_node(t);
+}
+
+/* Size of the memory block holding the table object. */
+static LJ_AINLINE size_t tab_objsize(const GCtab *t) {
+  return sizetabcolo((uint32_t)t->colo & 0x7f) + t->hcolo * sizeof(Node);
+}
+
 /* Create a new table. Note: the slots are not initialized (yet).
 */
 static GCtab* newtab(lua_State *L, uint32_t asize, uint32_t hbits) {
   GCtab *t;
+  uint32_t hcolo = 0;
+
+  if (hbits > 0 && hbits <= LJ_MAX_HCOLOBITS) {
+    hcolo = lj_pow2(hbits);
+  }
 
   /* Create table object and colocate array part if possible.
   */
   if (LJ_MAX_COLOSIZE != 0 && asize > 0 && asize <= LJ_MAX_COLOSIZE) {
     lua_assert((sizeof(GCtab) & 7) == 0);
-    t = (GCtab *)uj_obj_new(L, sizetabcolo(asize));
+    t = (GCtab *)uj_obj_new(L, sizetabcolo(asize) + hcolo * sizeof(Node));
     t->colo = (int8_t)asize;
+    t->hcolo = hcolo;
     t->array = (TValue *)((char *)t + sizeof(GCtab));
     t->asize = asize;
   } else {  /* Otherwise separately allocate the array part. */
-    t = (GCtab *)uj_obj_new(L, sizeof(GCtab));
+    t = (GCtab *)uj_obj_new(L, sizeof(GCtab) + hcolo * sizeof(Node));
     t->colo = 0;
+    t->hcolo = hcolo;  /* Object size must be known if allocation fails. */
     t->array = NULL;
     t->asize = 0;  /* In case the array allocation fails. */
     if (asize > 0) {
@@ -173,7 +199,15 @@ static GCtab* newtab(lua_State *L, uint32_t asize, uint32_t hbits) {
 
   /* Setup hash part.
   */
-  newhpart(L, t, hbits);
+  if (hcolo > 0) {
+    Node *node = tab_hcolo_node(t);
+    t->freetop = &node[hcolo];
+    t->node = node;
+    t->hmask = hcolo - 1;
+    clearhpart(t);
+  } else {
+    newhpart(L, t, hbits);
+  }
 
   G(L)->gc.tabnum++;
   return t;
@@ -203,6 +237,19 @@ GCtab* lj_tab_new_jit(lua_State *L, uint32_t ahsize) {
 }
 #endif
 
+/* Create a new table with array slots [1..a] and room for h hash entries.
+** Negative sizes are treated as zeros.
+*/
+GCtab* lj_tab_new_ah(lua_State *L, int32_t a, int32_t h) {
+  uint32_t asize = a > 0 ? (uint32_t)a + TAB_ARR_EL_START_IDX : 0;
+  uint32_t hbits = h > 0 ? hsize2hbits(h) : 0;
+  /* Check sizes upfront, so that no half-initialized table is left behind. */
+  if (asize > LJ_MAX_ASIZE || hbits > LJ_MAX_HBITS) {
+    uj_err(L, UJ_ERR_TABOV);
+  }
+  return newtab(L, asize, hbits);
+}
+
 /* Duplicate a table.
 */
 GCtab* lj_tab_dup(lua_State *L, const GCtab *kt) {
@@ -243,10 +290,21 @@ GCtab* lj_tab_dup(lua_State *L, const GCtab *kt) {
   return t;
 }
 
+/* Clear a table in place. Array and hash parts keep their sizes, so the
+** table can be refilled without reallocations.
+*/
+void lj_tab_clear(GCtab *t) {
+  clearapart(t);
+  if (t->hmask > 0) {
+    t->freetop = &t->node[t->hmask + 1];
+    clearhpart(t);
+  }
+}
+
 /* Free a table.
 */
 void lj_tab_free(global_State *g, GCtab *t) {
-  if (t->hmask > 0) {
+  if (t->hmask > 0 && !tab_hpart_iscolo(t)) {
     tab_hpart_free(g, t->node, t->hmask + 1);
   }
 
@@ -254,11 +312,7 @@ void lj_tab_free(global_State *g, GCtab *t) {
     uj_mem_free(MEM_G(g), t->array, t->asize * sizeof(TValue));
   }
 
-  if (LJ_MAX_COLOSIZE != 0 && t->colo) {
-    uj_mem_free(MEM_G(g), t, sizetabcolo((uint32_t)t->colo & 0x7f));
-  } else {
-    uj_mem_free(MEM_G(g), t, sizeof(*t));
-  }
+  uj_mem_free(MEM_G(g), t, tab_objsize(t));
 
   g->gc.tabnum--;
 }
@@ -268,17 +322,37 @@ void lj_tab_free(global_State *g, GCtab *t) {
 */
 size_t lj_tab_sizeof(const GCtab *t) {
   size_t hpart_size = t->hmask ? sizeof(Node) * (t->hmask + 1) : 0;
+  if (t->hcolo != 0 && !tab_hpart_iscolo(t)) {
+    hpart_size += sizeof(Node) * t->hcolo;  /* Abandoned colocated part. */
+  }
   return sizeof(GCtab) + sizeof(TValue) * t->asize + hpart_size;
 }
 
 /* -- Table resizing ------------------------------------------------------ */
 
+/* Insert a key from the old hash part of a table being resized. Keys are
+** unique, so the lookup done by lj_tab_set can be skipped: for large
+** tables it walks a hash chain of the new part per key for nothing.
+*/
+static LJ_AINLINE TValue *tab_reinsert(lua_State *L, GCtab *t,
+                                       const TValue *key) {
+  if (tvisnum(key)) {
+    lua_Number nk = numV(key);
+    int32_t k = lj_num2int(nk);
+    if (nk == (lua_Number)k && inarray(t, k)) {
+      return arrayslot(t, k);
+    }
+  }
+  return lj_tab_newkey(L, t, key);
+}
+
 /* Resize a table to fit the new array/hash part sizes.
 */
 static void resizetab(lua_State *L, GCtab *t, uint32_t asize, uint32_t hbits) {
   Node *oldnode = t->node;
   uint32_t oldasize = t->asize;
   uint32_t oldhmask = t->hmask;
+  int oldcolo = tab_hpart_iscolo(t);
   if (asize > oldasize) {  /* Array part grows? */
     TValue *array;
     uint32_t i;
@@ -325,10 +399,12 @@ static void resizetab(lua_State *L, GCtab *t, uint32_t asize, uint32_t hbits) {
     for (i = 0; i <= oldhmask; i++) {
       Node *n = &oldnode[i];
       if (!tvisnil(&n->val)) {
-        copyTV(L, lj_tab_set(L, t, &n->key), &n->val);
+        copyTV(L, tab_reinsert(L, t, &n->key), &n->val);
       }
     }
-    tab_hpart_free(G(L), oldnode, oldhmask + 1);
+    if (!oldcolo) {
+      tab_hpart_free(G(L), oldnode, oldhmask + 1);
+    }
   }
 }
 
@@ -596,7 +672,10 @@ TValue* lj_tab_newkey(lua_State *L, GCtab *t, const TValue *key) {
   }
   /* XXX: Do not use copyTV here: key may be dead (e.g. while rehashing). */
   n->key = *key;
-  if (LJ_UNLIKELY(tvismzero(&n->key))) { setrawV(&n->key, 0); }
+  /* Normalize -0 to +0. Payload bits of non-numbers are not meaningful. */
+  if (LJ_UNLIKELY(tvisnum(&n->key) && tvismzero(&n->key))) {
+    setrawV(&n->key, 0);
+  }
   lj_gc_anybarriert(L, t);
   lua_assert(tvisnil(&n->val));
   return &n->val;
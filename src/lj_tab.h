@@ -34,7 +34,9 @@ GCtab *lj_tab_new(lua_State *L, uint32_t asize, uint32_t hbits);
 #if LJ_HASJIT
 GCtab * lj_tab_new_jit(lua_State *L, uint32_t ahsize);
 #endif
+GCtab * lj_tab_new_ah(lua_State *L, int32_t a, int32_t h);
 GCtab * lj_tab_dup(lua_State *L, const GCtab *kt);
+void lj_tab_clear(GCtab *t);
 void lj_tab_free(global_State *g, GCtab *t);
 #if LJ_HASFFI
 void lj_tab_rehash(lua_State *L, GCtab *t);
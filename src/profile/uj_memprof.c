@@ -5,12 +5,17 @@
  * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
  */
 
+#define _GNU_SOURCE 1 /* dladdr */
+
 #include "profile/uj_memprof_iface.h"
 #include "lextlib.h"
 #include "lj_def.h"
 
 #ifdef UJIT_MEMPROF
 
+#include <dlfcn.h>
+#include <math.h>
+#include <time.h>
 #include <unistd.h>
 #ifdef UJIT_IS_THREAD_SAFE
 #include <pthread.h>
@@ -21,6 +26,7 @@
 #include "lj_obj.h"
 #include "lj_frame.h"
 #include "lj_debug.h"
+#include "uj_proto.h"
 #include "uj_vmstate.h"
 #include "uj_timerint.h"
 #include "profile/uj_symtab.h"
@@ -51,9 +57,16 @@
  */
 #define STREAM_BUFFER_SIZE (10 * 1024 * 1024)
 
+/* Sampling mode: Max number of innermost frames reported for a sample. */
+#define SAMPLE_MAXFRAMES 64
+
+/* Sampling mode: Initial number of slots in the hash of stacks. */
+#define SAMPLE_MINSLOTS 256
+
 enum memprof_state {
 	MPS_IDLE, /* memprof not running */
-	MPS_PROFILE /* memprof running */
+	MPS_PROFILE, /* memprof running */
+	MPS_SAMPLE /* memprof running in sampling mode */
 };
 
 struct alloc {
@@ -61,6 +74,15 @@ struct alloc {
 	void *state; /* Opaque allocator's state. */
 };
 
+/* Sampling mode: Allocations aggregated by a call stack. */
+struct sample {
+	uint64_t hash; /* Hash of the stack. */
+	uint64_t count; /* Number of samples. */
+	double nbytes; /* Estimated number of allocated bytes. */
+	size_t len; /* Length of the stack. */
+	char stack[1]; /* Collapsed stack, outermost frame first. */
+};
+
 struct memprof {
 	global_State *g; /* Profiled VM. */
 	uint64_t nticks; /* Ticks at the latest timestamp event. */
@@ -69,6 +91,11 @@ struct memprof {
 	struct ujp_buffer out; /* Output accumulator. */
 	struct alloc orig_alloc; /* Original allocator. */
 	struct memprof_options opt; /* Profiling options. */
+	int64_t countdown; /* Sampling: Bytes to allocate till the next sample. */
+	uint64_t rng; /* Sampling: State of the PRNG. */
+	struct sample **samples; /* Sampling: Open addressing hash of stacks. */
+	size_t nslots; /* Sampling: Number of slots, a power of 2. */
+	size_t nsamples; /* Sampling: Number of occupied slots. */
 };
 
 #ifdef UJIT_IS_THREAD_SAFE
@@ -294,6 +321,293 @@ static void *memprof_allocf(void *ud, void *ptr, size_t osize, size_t nsize)
 	return nptr;
 }
 
+/*
+ * Sampling mode: Instead of streaming each event, one allocation per
+ * opt.sample_rate bytes on average is sampled. Intervals between samples are
+ * exponentially distributed (Poisson process over allocated bytes, the same
+ * technique as jemalloc's heap profiling uses), so that all allocation sites
+ * are sampled with the probability proportional to the number of allocated
+ * bytes. Samples are aggregated by the call stack in a hash table which is
+ * allocated with the original allocator to avoid recursion. Frees are not
+ * tracked, so the report shows allocated (not live) memory.
+ */
+
+static LJ_AINLINE void *memprof_raw_alloc(struct memprof *mp, size_t size)
+{
+	return mp->orig_alloc.allocf(mp->orig_alloc.state, NULL, 0, size);
+}
+
+static LJ_AINLINE void memprof_raw_free(struct memprof *mp, void *p,
+					size_t size)
+{
+	mp->orig_alloc.allocf(mp->orig_alloc.state, p, size, 0);
+}
+
+/* xorshift64* */
+static LJ_AINLINE uint64_t memprof_random(struct memprof *mp)
+{
+	uint64_t x = mp->rng;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	mp->rng = x;
+	return x * UINT64_C(0x2545f4914f6cdd1d);
+}
+
+static int64_t memprof_sample_interval(struct memprof *mp)
+{
+	/* Uniformly distributed in (0, 1]: */
+	const double u = (double)((memprof_random(mp) >> 11) + 1) *
+			 (1.0 / 9007199254740992.0);
+	const double interval = -log(u) * (double)mp->opt.sample_rate;
+
+	return interval < 1.0 ? 1 : (int64_t)interval;
+}
+
+static void memprof_sample_fname(char *name, lua_State *L, GCfunc *fn,
+				 const TValue *nextframe)
+{
+	if (isluafunc(fn)) {
+		BCPos pos = lj_debug_framepc(L, fn, nextframe);
+
+		uj_proto_sprintloc(name, funcproto(fn),
+				   pos != NO_BCPOS ? pos : 0);
+	} else if (isffunc(fn)) {
+		sprintf(name, "builtin#%d", (int)fn->c.ffid);
+	} else {
+		void *addr = (void *)(uintptr_t)fn->c.f;
+		Dl_info info;
+
+		if (dladdr(addr, &info) && info.dli_sname != NULL)
+			snprintf(name, FORMATTED_LOC_BUF_SIZE, "%s",
+				 info.dli_sname);
+		else
+			sprintf(name, "C:%p", addr);
+	}
+}
+
+/*
+ * Writes the collapsed stack of the current allocation to buf, returns its
+ * length. buf must fit SAMPLE_MAXFRAMES + 1 names of FORMATTED_LOC_BUF_SIZE.
+ */
+static size_t memprof_sample_stack(struct memprof *mp, char *buf)
+{
+	char names[SAMPLE_MAXFRAMES][FORMATTED_LOC_BUF_SIZE];
+	global_State *g = mp->g;
+	uint32_t vmstate = (uint32_t)uj_vmstate_get(&g->vmstate);
+	lua_State *L = g->L_mem;
+	const TValue *nextframe = NULL;
+	const TValue *frame;
+	size_t nframes = 0;
+	size_t len = 0;
+
+	if (vmstate >= UJ_VMST_TRACE)
+		return (size_t)sprintf(buf, "[TRACE]");
+
+	if (vmstate >= UJ_VMST_HVMST_START)
+		return (size_t)sprintf(buf, "[%s]", uj_vmstate_names[vmstate]);
+
+	/* Traverse frames backwards, see lj_debug_frame. */
+	frame = L->base - 1;
+	while (frame > L->stack && nframes < SAMPLE_MAXFRAMES) {
+		if (frame_isvarg(frame)) {
+			frame = frame_prevd(frame);
+			continue;
+		}
+
+		if (!frame_isdummy(L, frame))
+			memprof_sample_fname(names[nframes++], L,
+					     frame_func(frame), nextframe);
+
+		nextframe = frame;
+		frame = frame_prev(frame);
+	}
+
+	if (frame > L->stack)
+		len += (size_t)sprintf(buf, "[truncated];");
+
+	while (nframes > 0) {
+		const char *name = names[--nframes];
+		size_t szname = strlen(name);
+
+		memcpy(buf + len, name, szname);
+		len += szname;
+		buf[len++] = nframes > 0 ? ';' : '\0';
+	}
+
+	if (len == 0)
+		return (size_t)sprintf(buf, "[%s]", uj_vmstate_names[vmstate]);
+
+	return len - 1;
+}
+
+/* FNV-1a */
+static uint64_t memprof_sample_hash(const char *stack, size_t len)
+{
+	uint64_t hash = UINT64_C(0xcbf29ce484222325);
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= (uint8_t)stack[i];
+		hash *= UINT64_C(0x100000001b3);
+	}
+	return hash;
+}
+
+static struct sample **memprof_sample_slot(struct sample **samples,
+					   size_t nslots, uint64_t hash,
+					   const char *stack, size_t len)
+{
+	size_t i = (size_t)hash & (nslots - 1);
+
+	for (;;) {
+		struct sample *sample = samples[i];
+
+		if (sample == NULL || (sample->hash == hash &&
+				       sample->len == len &&
+				       memcmp(sample->stack, stack, len) == 0))
+			return &samples[i];
+
+		i = (i + 1) & (nslots - 1);
+	}
+}
+
+static int memprof_sample_resize(struct memprof *mp, size_t nslots)
+{
+	struct sample **samples;
+	size_t i;
+
+	samples = (struct sample **)memprof_raw_alloc(
+		mp, nslots * sizeof(*samples));
+	if (samples == NULL)
+		return 1;
+
+	memset(samples, 0, nslots * sizeof(*samples));
+
+	for (i = 0; i < mp->nslots; i++) {
+		struct sample *sample = mp->samples[i];
+
+		if (sample != NULL)
+			*memprof_sample_slot(samples, nslots, sample->hash,
+					     sample->stack, sample->len) =
+				sample;
+	}
+
+	if (mp->samples != NULL)
+		memprof_raw_free(mp, mp->samples,
+				 mp->nslots * sizeof(*mp->samples));
+
+	mp->samples = samples;
+	mp->nslots = nslots;
+	return 0;
+}
+
+static void memprof_sample_free(struct memprof *mp)
+{
+	size_t i;
+
+	for (i = 0; i < mp->nslots; i++) {
+		struct sample *sample = mp->samples[i];
+
+		if (sample != NULL)
+			memprof_raw_free(mp, sample,
+					 sizeof(*sample) + sample->len);
+	}
+
+	memprof_raw_free(mp, mp->samples, mp->nslots * sizeof(*mp->samples));
+	mp->samples = NULL;
+	mp->nslots = 0;
+	mp->nsamples = 0;
+}
+
+static LJ_NOINLINE void memprof_sample(struct memprof *mp, size_t size)
+{
+	char stack[(SAMPLE_MAXFRAMES + 1) * FORMATTED_LOC_BUF_SIZE];
+	const size_t len = memprof_sample_stack(mp, stack);
+	const uint64_t hash = memprof_sample_hash(stack, len);
+	struct sample **slot;
+	struct sample *sample;
+
+	mp->countdown = memprof_sample_interval(mp);
+
+	slot = memprof_sample_slot(mp->samples, mp->nslots, hash, stack, len);
+	sample = *slot;
+
+	if (sample == NULL) {
+		/* Keep the load factor <= 1/2, drop the sample if out of memory. */
+		if (2 * (mp->nsamples + 1) > mp->nslots) {
+			if (memprof_sample_resize(mp, 2 * mp->nslots) != 0)
+				return;
+			slot = memprof_sample_slot(mp->samples, mp->nslots,
+						   hash, stack, len);
+		}
+
+		sample = (struct sample *)memprof_raw_alloc(
+			mp, sizeof(*sample) + len);
+		if (sample == NULL)
+			return;
+
+		sample->hash = hash;
+		sample->count = 0;
+		sample->nbytes = 0;
+		sample->len = len;
+		memcpy(sample->stack, stack, len);
+		sample->stack[len] = '\0';
+
+		*slot = sample;
+		mp->nsamples++;
+	}
+
+	/*
+	 * An allocation of size bytes is sampled with the probability
+	 * 1 - exp(-size / rate), so it stands for size / probability bytes.
+	 */
+	sample->count++;
+	sample->nbytes += (double)size /
+			  (1.0 - exp(-(double)size / (double)mp->opt.sample_rate));
+}
+
+static void *memprof_sample_allocf(void *ud, void *ptr, size_t osize,
+				   size_t nsize)
+{
+	struct memprof *mp = &memprof;
+	struct alloc *oalloc = &mp->orig_alloc;
+	void *nptr;
+
+	lua_assert(MPS_SAMPLE == mp->state);
+	lua_assert(ud == oalloc->state);
+
+	nptr = oalloc->allocf(ud, ptr, osize, nsize);
+
+	if (nsize != 0) {
+		mp->countdown -= (int64_t)nsize;
+		if (LJ_UNLIKELY(mp->countdown <= 0) && nptr != NULL)
+			memprof_sample(mp, nsize);
+	}
+
+	return nptr;
+}
+
+int uj_memprof_report(const struct lua_State *L, FILE *out)
+{
+	struct memprof *mp = &memprof;
+	size_t i;
+
+	if (mp->state != MPS_SAMPLE || mp->g != G(L))
+		return LUAE_PROFILE_ERR;
+
+	for (i = 0; i < mp->nslots; i++) {
+		const struct sample *sample = mp->samples[i];
+
+		if (sample != NULL)
+			fprintf(out, "%s %" PRIu64 "\n", sample->stack,
+				(uint64_t)sample->nbytes);
+	}
+
+	return LUAE_PROFILE_SUCCESS;
+}
+
 static void memprof_write_prologue(struct ujp_buffer *out)
 {
 	size_t i = 0;
@@ -303,6 +617,39 @@ static void memprof_write_prologue(struct ujp_buffer *out)
 		ujp_write_byte(out, ujm_header[i]);
 }
 
+/* Must be called under the lock. */
+static int memprof_start_sampling(struct lua_State *L,
+				  const struct memprof_options *opt)
+{
+	struct memprof *mp = &memprof;
+	struct alloc *oalloc = &mp->orig_alloc;
+
+	if (mp->state != MPS_IDLE)
+		return LUAE_PROFILE_ERR;
+
+	memcpy(&mp->opt, opt, sizeof(*opt));
+
+	oalloc->allocf = lua_getallocf(L, &oalloc->state);
+	lua_assert(oalloc->allocf != NULL);
+	lua_assert(oalloc->allocf != memprof_allocf);
+	lua_assert(oalloc->allocf != memprof_sample_allocf);
+
+	mp->samples = NULL;
+	mp->nslots = 0;
+	mp->nsamples = 0;
+	if (memprof_sample_resize(mp, SAMPLE_MINSLOTS) != 0)
+		return LUAE_PROFILE_ERRMEM;
+
+	mp->g = G(L);
+	mp->state = MPS_SAMPLE;
+	mp->rng = (uint64_t)time(NULL) ^ (uint64_t)(uintptr_t)L ^
+		  UINT64_C(0x9e3779b97f4a7c15);
+	mp->countdown = memprof_sample_interval(mp);
+
+	lua_setallocf(L, memprof_sample_allocf, oalloc->state);
+	return LUAE_PROFILE_SUCCESS;
+}
+
 int uj_memprof_start(struct lua_State *L, const struct memprof_options *opt)
 {
 	struct memprof *mp = &memprof;
@@ -311,6 +658,13 @@ int uj_memprof_start(struct lua_State *L, const struct memprof_options *opt)
 
 	memprof_lock();
 
+	if (opt->sample_rate != 0) {
+		int status = memprof_start_sampling(L, opt);
+
+		memprof_unlock();
+		return status;
+	}
+
 	if (uj_timerint_init_default() != LUAE_INT_SUCCESS) {
 		memprof_unlock();
 		return LUAE_PROFILE_ERR;
@@ -364,7 +718,7 @@ static int memprof_stop(const struct global_State *g)
 
 	memprof_lock();
 
-	if (mp->state != MPS_PROFILE) {
+	if (mp->state == MPS_IDLE) {
 		memprof_unlock();
 		return LUAE_PROFILE_ERR;
 	}
@@ -374,11 +728,20 @@ static int memprof_stop(const struct global_State *g)
 		return LUAE_PROFILE_ERR;
 	}
 
-	mp->state = MPS_IDLE;
-
 	lua_assert(mp->g != NULL);
 	L = mainthread(mp->g);
 
+	if (mp->state == MPS_SAMPLE) {
+		mp->state = MPS_IDLE;
+		lua_assert(memprof_sample_allocf == lua_getallocf(L, NULL));
+		lua_setallocf(L, oalloc->allocf, oalloc->state);
+		memprof_sample_free(mp);
+		memprof_unlock();
+		return LUAE_PROFILE_SUCCESS;
+	}
+
+	mp->state = MPS_IDLE;
+
 	lua_assert(memprof_allocf == lua_getallocf(L, NULL));
 	lua_assert(oalloc->allocf != NULL);
 	lua_assert(oalloc->state != NULL);
@@ -420,6 +783,13 @@ int uj_memprof_stop(void)
 	return LUA_PROFILE_ERR;
 }
 
+int uj_memprof_report(const struct lua_State *L, FILE *out)
+{
+	UNUSED(L);
+	UNUSED(out);
+	return LUA_PROFILE_ERR;
+}
+
 int uj_memprof_stop_vm(const struct global_State *g)
 {
 	UNUSED(g);
@@ -9,6 +9,7 @@
 #define _UJ_MEMPROF_IFACE_H
 
 #include <stdint.h>
+#include <stdio.h>
 
 struct lua_State;
 struct global_State;
@@ -20,6 +21,12 @@ struct global_State;
 struct memprof_options {
 	uint64_t dursec; /* Approximate duration of profiling, seconds. */
 	int fd; /* File descriptor for writing output. */
+	/*
+	 * Mean number of allocated bytes between two samples. If 0, all events
+	 * are streamed to fd. Otherwise sampled allocations are aggregated by
+	 * call stack in memory, dursec and fd are ignored.
+	 */
+	uint64_t sample_rate;
 };
 
 /*
@@ -34,6 +41,14 @@ int uj_memprof_start(struct lua_State *L, const struct memprof_options *opt);
  */
 int uj_memprof_stop(void);
 
+/*
+ * Writes allocations aggregated by call stack in the collapsed stack format
+ * ("frame;frame;...;frame bytes" per line, outermost frame first) to out.
+ * Returns LUAE_PROFILE_SUCCESS on success and LUAE_PROFILE_ERR if L's VM is
+ * not being profiled in sampling mode.
+ */
+int uj_memprof_report(const struct lua_State *L, FILE *out);
+
 /*
  * VM g is currently being profiled, behaves exactly as uj_memprof_stop().
  * Otherwise does nothing and returns LUAE_PROFILE_ERR.
@@ -4,6 +4,10 @@
  * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
  */
 
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include "lua.h"
 #include "lauxlib.h"
 #include "lextlib.h"
@@ -20,6 +24,10 @@
 #include "lj_tab.h"
 #include "uj_func.h"
 #include "uj_timerint.h"
+#include "uj_sbuf.h"
+#include "uj_str.h"
+#include "uj_serial.h"
+#include "uj_err.h"
 #include "uj_coverage.h"
 #include "utils/uj_alloc.h"
 #include "profile/uj_profile_iface.h"
@@ -127,10 +135,20 @@ LUAEXT_API struct luae_Metrics luaE_metrics(lua_State *L)
 
 	rv.jit_mcode_size = J->szallmcarea;
 	rv.jit_trace_num = J->freetrace;
+
+	rv.jit_compile_ns = J->compile_ns;
+	J->compile_ns = 0;
+
+	rv.jit_compile_ns_max = J->compile_ns_max;
+	J->compile_ns_max = 0;
+
+	memset(J->naborts, 0, sizeof(J->naborts));
 #else
 	rv.jit_snap_restore = 0;
 	rv.jit_mcode_size = 0;
 	rv.jit_trace_num = 0;
+	rv.jit_compile_ns = 0;
+	rv.jit_compile_ns_max = 0;
 #endif
 
 	return rv;
@@ -172,6 +190,106 @@ LUAEXT_API lua_State *luaE_createstate(const struct luae_Options *opt)
 	return uj_state_newstate(opt);
 }
 
+struct capi_ext_save {
+	FILE *out;
+	int written;
+};
+
+static int capi_ext_savedataroot(lua_State *L)
+{
+	struct capi_ext_save *save = lua_touserdata(L, 1);
+	struct sbuf *sb = uj_sbuf_reset_tmp(L);
+	TValue root;
+	size_t size;
+
+	settabV(L, &root, G(L)->dataroot);
+	uj_sbuf_push_block(sb, UJ_SERIAL_IMAGE_MAGIC,
+			   UJ_SERIAL_IMAGE_MAGIC_SIZE);
+	uj_serial_encode(L, sb, &root, UJ_SERIAL_FUNC);
+
+	size = uj_sbuf_size(sb);
+	save->written = fwrite(uj_sbuf_front(sb), 1, size, save->out) == size &&
+			fflush(save->out) == 0;
+	uj_sbuf_shrink_tmp(L);
+	return 0;
+}
+
+LUAEXT_API int luaE_savedataroot(lua_State *L, FILE *out)
+{
+	struct capi_ext_save save;
+
+	api_check(L, NULL != G(L)->dataroot);
+
+	save.out = out;
+	save.written = 0;
+	if (lua_cpcall(L, capi_ext_savedataroot, &save) != 0) {
+		lua_pop(L, 1);
+		return 1;
+	}
+
+	return !save.written;
+}
+
+struct capi_ext_image {
+	const uint8_t *buf;
+	size_t size;
+};
+
+static int capi_ext_loaddatastate(lua_State *L)
+{
+	const struct capi_ext_image *img = lua_touserdata(L, 1);
+
+	if (img->size < UJ_SERIAL_IMAGE_MAGIC_SIZE ||
+	    memcmp(img->buf, UJ_SERIAL_IMAGE_MAGIC,
+		   UJ_SERIAL_IMAGE_MAGIC_SIZE) != 0)
+		uj_err(L, UJ_ERR_SERIAL_BADDATA);
+
+	uj_serial_decode(L, img->buf + UJ_SERIAL_IMAGE_MAGIC_SIZE,
+			 img->size - UJ_SERIAL_IMAGE_MAGIC_SIZE, UJ_SERIAL_FUNC);
+	if (!lua_istable(L, -1))
+		uj_err(L, UJ_ERR_SERIAL_BADDATA);
+
+	luaE_setdataroot(L, -1);
+	luaE_seal(L, -1);
+	return 0;
+}
+
+LUAEXT_API lua_State *luaE_loaddatastate(const struct luae_Options *opt,
+					 FILE *in)
+{
+	struct capi_ext_image img;
+	struct stat st;
+	void *map;
+	lua_State *L;
+	int status;
+
+	if (opt != NULL && opt->datastate != NULL)
+		return NULL;
+
+	if (fstat(fileno(in), &st) != 0 || st.st_size <= 0)
+		return NULL;
+
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+		   fileno(in), 0);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	img.buf = (const uint8_t *)map;
+	img.size = (size_t)st.st_size;
+
+	L = uj_state_newstate(opt);
+	if (L != NULL) {
+		status = lua_cpcall(L, capi_ext_loaddatastate, &img);
+		if (status != 0) {
+			lua_close(L);
+			L = NULL;
+		}
+	}
+
+	munmap(map, img.size);
+	return L;
+}
+
 LUAEXT_API size_t luaE_totalmem(void)
 {
 	struct alloc_stats stats = uj_alloc_stats();
@@ -250,6 +368,11 @@ LUAEXT_API void luaE_dumpbcsource(lua_State *L, int idx, FILE *out,
 	uj_dump_bc_and_source(out, funcV(tv), pos);
 }
 
+LUAEXT_API void luaE_dumpheap(lua_State *L, FILE *out)
+{
+	uj_dump_heap(out, L);
+}
+
 LUAEXT_API uint64_t luaE_iterate(lua_State *L, int idx, uint64_t iter_state)
 {
 	const TValue *t = uj_capi_index2adr(L, idx);
@@ -350,6 +473,24 @@ LUAEXT_API void luaE_deepcopytable(lua_State *to, lua_State *from, int idx)
 	uj_state_stack_incr_top(to);
 }
 
+LUAEXT_API void luaE_serialize(lua_State *L, int idx)
+{
+	const TValue *tv = uj_capi_index2adr(L, idx);
+	struct sbuf *sb = uj_sbuf_reset_tmp(L);
+
+	uj_serial_encode(L, sb, tv, 0);
+	setstrV(L, L->top, uj_str_frombuf(L, sb));
+	uj_state_stack_incr_top(L);
+	uj_sbuf_shrink_tmp(L);
+	lj_gc_check(L);
+}
+
+LUAEXT_API void luaE_deserialize(lua_State *L, const char *buf, size_t len)
+{
+	uj_serial_decode(L, (const uint8_t *)buf, len, 0);
+	lj_gc_check(L);
+}
+
 LUAEXT_API int luaE_coveragestart(lua_State *L, const char *filename,
 				  const char **excludes, size_t num)
 {
@@ -27,6 +27,8 @@ struct cframe {
 	struct lua_State *L;
 	BCIns *pc;
 	void *cframe_prev;
+	uint64_t savereg_r12;
+	uint64_t savereg_r13;
 	uint64_t savereg_r14;
 	uint64_t savereg_r15;
 	uint64_t savereg_rbx;
@@ -10,15 +10,252 @@
  * Copyright (C) 1994-2008 Lua.org, PUC-Rio. See Copyright Notice in lua.h
  */
 
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "uj_cstr.h"
 #include "lj_obj.h"
 #include "utils/fp.h"
 #include "utils/strscan.h"
 
+/*
+ * Exact formatting of finite doubles, byte-to-byte compatible with printf's
+ * %.<prec>g. A positive double is m * 2^e2, so for a decimal scale 10^s the
+ * scaled value m * 5^s * 2^(e2 + s) is computed exactly with 128-bit integers
+ * and rounded half-to-even, just like libc does. Magnitudes for which the
+ * intermediate values do not fit are left to libc.
+ */
+
+__extension__ typedef unsigned __int128 cstr_u128;
+
+#define CSTR_MAXPOW5 27 /* 5^27 < 2^63 */
+#define CSTR_MAXPOW10 19 /* 10^19 < 2^64 */
+
+static const uint64_t cstr_pow10[CSTR_MAXPOW10 + 1] = {
+	1ULL,
+	10ULL,
+	100ULL,
+	1000ULL,
+	10000ULL,
+	100000ULL,
+	1000000ULL,
+	10000000ULL,
+	100000000ULL,
+	1000000000ULL,
+	10000000000ULL,
+	100000000000ULL,
+	1000000000000ULL,
+	10000000000000ULL,
+	100000000000000ULL,
+	1000000000000000ULL,
+	10000000000000000ULL,
+	100000000000000000ULL,
+	1000000000000000000ULL,
+	10000000000000000000ULL
+};
+
+static LJ_AINLINE cstr_u128 cstr_round_even(cstr_u128 q, cstr_u128 rem,
+					    cstr_u128 div)
+{
+	if (rem > div - rem || (rem == div - rem && (q & 1)))
+		q++;
+	return q;
+}
+
+/*
+ * Stores round(m * 2^e2 * 10^s) to *r. Returns 0 on success and non-0 if the
+ * exact result cannot be computed.
+ */
+static int cstr_scale(uint64_t m, int32_t e2, int32_t s, cstr_u128 *r)
+{
+	cstr_u128 v;
+	int32_t sh;
+
+	if (s >= 0) {
+		uint64_t p5 = 1;
+
+		if (s > CSTR_MAXPOW5)
+			return 1;
+		while (s-- > 0) {
+			p5 *= 5;
+			e2++;
+		}
+		v = (cstr_u128)m * p5;
+		if (e2 >= 0) {
+			if (e2 > 127 - 116) /* v < 2^116 */
+				return 1;
+			*r = v << e2;
+			return 0;
+		}
+		sh = -e2;
+		if (sh >= 127)
+			return 1;
+		*r = cstr_round_even(v >> sh, v & (((cstr_u128)1 << sh) - 1),
+				     (cstr_u128)1 << sh);
+		return 0;
+	}
+
+	/* Divide m * 2^e2 by 10^-s, the operands are shifted to be integer. */
+	if (-s > CSTR_MAXPOW10 || e2 > 127 - 53 || e2 < -(127 - 64))
+		return 1;
+	v = (cstr_u128)m << (e2 > 0 ? e2 : 0);
+	{
+		cstr_u128 div = (cstr_u128)cstr_pow10[-s] << (e2 < 0 ? -e2 : 0);
+
+		*r = cstr_round_even(v / div, v % div, div);
+	}
+	return 0;
+}
+
+/*
+ * Computes the first prec significant decimal digits of n > 0 (stored to *d)
+ * and the decimal exponent *x of the first one. Returns 0 on success and non-0
+ * if the result cannot be computed exactly.
+ */
+static int cstr_digits(lua_Number n, int prec, uint64_t *d, int32_t *x)
+{
+	FpConv conv;
+	uint64_t m;
+	int32_t e2, ex;
+	const uint64_t hi = cstr_pow10[prec];
+	const uint64_t lo = cstr_pow10[prec - 1];
+	int i;
+
+	conv.d = n;
+	e2 = (int32_t)((conv.u >> 52) & 0x7ff);
+	if (e2 == 0)
+		return 1; /* Denormals are too small anyway. */
+	m = (conv.u & ((1ULL << 52) - 1)) | (1ULL << 52);
+	e2 -= 1023 + 52;
+
+	/* Estimate of floor(log10(n)), corrected in the loop below. */
+	ex = ((e2 + 52) * 1233) >> 12;
+
+	for (i = 0; i < 3; i++) {
+		cstr_u128 r;
+
+		if (cstr_scale(m, e2, prec - 1 - ex, &r) != 0)
+			return 1;
+
+		if (r < lo) {
+			ex--;
+		} else if (r == hi) {
+			/* Rounded up to the next power of 10. */
+			*d = lo;
+			*x = ex + 1;
+			return 0;
+		} else if (r > hi) {
+			ex++;
+		} else {
+			*d = (uint64_t)r;
+			*x = ex;
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Prints exactly prec digits of d to s, returns the end of printed digits. */
+static char *cstr_print_digits(char *s, uint64_t d, int prec)
+{
+	char *p = s + prec;
+
+	while (p > s) {
+		*--p = '0' + d % 10;
+		d /= 10;
+	}
+	return s + prec;
+}
+
+static char *cstr_strip_zeros(char *s, char *point)
+{
+	while (s[-1] == '0')
+		s--;
+	return s - 1 == point ? point : s;
+}
+
+/* Formats n != 0 as %.<prec>g does. Returns 0 if n cannot be handled. */
+static size_t cstr_fmt_g(char *s, lua_Number n, int prec)
+{
+	char buf[CSTR_MAXPOW10 + 1];
+	char *p = s;
+	uint64_t d;
+	int32_t x;
+
+	lua_assert(prec > 0 && prec < CSTR_MAXPOW10);
+
+	if (n < 0) {
+		*p++ = '-';
+		n = -n;
+	}
+
+	if (cstr_digits(n, prec, &d, &x) != 0)
+		return 0;
+
+	cstr_print_digits(buf, d, prec);
+
+	if (x < -4 || x >= prec) {
+		uint32_t ux = x < 0 ? -x : x;
+
+		*p++ = buf[0];
+		*p = '.';
+		memcpy(p + 1, buf + 1, prec - 1);
+		p = cstr_strip_zeros(p + prec, p);
+		*p++ = 'e';
+		*p++ = x < 0 ? '-' : '+';
+		if (ux >= 100)
+			*p++ = '0' + ux / 100;
+		*p++ = '0' + ux / 10 % 10;
+		*p++ = '0' + ux % 10;
+	} else if (x >= 0) {
+		memcpy(p, buf, x + 1);
+		p += x + 1;
+		*p = '.';
+		memcpy(p + 1, buf + x + 1, prec - 1 - x);
+		p = cstr_strip_zeros(p + prec - x, p);
+	} else {
+		*p++ = '0';
+		*p = '.';
+		memset(p + 1, '0', -x - 1);
+		memcpy(p - x, buf, prec);
+		p = cstr_strip_zeros(p - x + prec, p);
+	}
+
+	return (size_t)(p - s);
+}
+
+/* Prints n if it is an integer which %.14g prints without an exponent. */
+static size_t cstr_fromnum_int(char *s, lua_Number n)
+{
+	int32_t k = lj_num2int(n);
+	int64_t k64;
+	char *p = s;
+
+	if ((lua_Number)k == n) {
+		if (k == 0 && signbit(n))
+			return 0; /* -0 */
+		return uj_cstr_fromint(s, k);
+	}
+
+	if (!(n > -1e14 && n < 1e14))
+		return 0;
+
+	k64 = (int64_t)n;
+	if ((lua_Number)k64 != n)
+		return 0;
+
+	if (k64 < 0) {
+		*p++ = '-';
+		k64 = -k64;
+	}
+	return (size_t)(p - s) + uj_cstr_fromu64(p, (uint64_t)k64);
+}
+
 size_t uj_cstr_fromnum(char *s, lua_Number n)
 {
+	size_t len;
+
 	switch (uj_fp_classify(n)) {
 	case LJ_FP_NAN:
 		s[0] = 'n';
@@ -37,10 +274,31 @@ size_t uj_cstr_fromnum(char *s, lua_Number n)
 		s[3] = 'f';
 		return 4;
 	default: /* == LJ_FP_FINITE */
+		len = cstr_fromnum_int(s, n);
+		if (len != 0)
+			return len;
+		if (n != 0) {
+			len = cstr_fmt_g(s, n, UJ_CSTR_NUMPREC);
+			if (len != 0)
+				return len;
+		}
 		return (size_t)lua_number2str(s, n);
 	}
 }
 
+size_t uj_cstr_fromnumg(char *s, lua_Number n, int prec)
+{
+	size_t len;
+
+	lua_assert(lj_fp_finite(n));
+	if (prec > 0 && prec < CSTR_MAXPOW10 && n != 0) {
+		len = cstr_fmt_g(s, n, prec);
+		if (len != 0)
+			return len;
+	}
+	return (size_t)sprintf(s, "%.*g", prec, n);
+}
+
 static LJ_AINLINE char *cstr_print_four_digits(char *s, uint32_t u, int padded)
 {
 	if (!padded) {
@@ -103,6 +361,25 @@ size_t uj_cstr_fromint(char *s, int32_t k)
 	return cstr_print_four_digits(p, lo, 1) - s;
 }
 
+size_t uj_cstr_fromu64(char *s, uint64_t u)
+{
+	char buf[UJ_CSTR_U64BUF];
+	char *p = buf + sizeof(buf);
+	size_t len;
+
+	if (u <= 0x7fffffff)
+		return uj_cstr_fromint(s, (int32_t)u);
+
+	do {
+		*--p = '0' + u % 10;
+		u /= 10;
+	} while (u != 0);
+
+	len = (size_t)(buf + sizeof(buf) - p);
+	memcpy(s, p, len);
+	return len;
+}
+
 int uj_cstr_tonum(const char *buf, lua_Number *n)
 {
 	double d;
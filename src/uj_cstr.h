@@ -18,14 +18,30 @@
 typedef union TValue TValue;
 
 #define UJ_CSTR_INTBUF (1 + 10)
+#define UJ_CSTR_U64BUF 20
 #define UJ_CSTR_NUMBUF LUAI_MAXNUMBER2STR
 
-/* Print number to buffer. Canonicalizes non-finite values. */
+/* Number of significant digits used for printing numbers, see LUA_NUMBER_FMT */
+#define UJ_CSTR_NUMPREC 14
+
+/*
+ * Print number to buffer as LUA_NUMBER_FMT does. Canonicalizes non-finite
+ * values.
+ */
 size_t uj_cstr_fromnum(char *s, lua_Number n);
 
+/*
+ * Print finite number to buffer as "%.<prec>g" does. The buffer must be large
+ * enough to hold the output of sprintf.
+ */
+size_t uj_cstr_fromnumg(char *s, lua_Number n, int prec);
+
 /* Print integer to buffer. */
 size_t uj_cstr_fromint(char *s, int32_t k);
 
+/* Print unsigned 64-bit integer to buffer. */
+size_t uj_cstr_fromu64(char *s, uint64_t u);
+
 /*
  * Tries to convert a C string buffer `buf` to a number. In case of success,
  * stores the result into `lua_Number` pointed by `n`.
@@ -53,6 +53,14 @@ void uj_dispatch_init(struct GG_State *GG)
 	for (op = 0; op < GG_LEN_SDISP; op++)
 		dispatch_as(disp, GG_LEN_DDISP + op, dispatch_bc_semantic(op));
 
+	/*
+	 * Fused instructions enter the handler of the next instruction
+	 * directly, bypassing both recording and instruction hooks. Hence
+	 * static dispatch maps them to the first instruction in the pair.
+	 */
+	dispatch_as(disp, GG_LEN_DDISP + BC_TGETSS,
+		    dispatch_bc_semantic(BC_TGETS));
+
 	/*
 	 * Since JIT part is disabled by default, treat profiling
 	 * instructions as interpreted system-wide.
@@ -170,6 +178,8 @@ static void dispatch_update(struct global_State *g, uint8_t mode)
 			/* Copy static dispatch table to dynamic one. */
 			memcpy(&disp[0], &disp[GG_LEN_DDISP],
 			       GG_LEN_SDISP * sizeof(ASMFunction));
+			/* Restore fused instructions. */
+			dispatch_as_default(disp, BC_TGETSS);
 			/* Overwrite with dynamic return dispatch. */
 			dispatch_set_dynamic_return(disp, mode);
 		} else {
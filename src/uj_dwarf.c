@@ -50,7 +50,9 @@
  * - EXT is mandatory on WIN64 since the calling convention has an abundance
  *   of callee-saved registers (rbx, rbp, rsi, rdi, r12-r15, xmm6-xmm15).
  *
- * - EXT is mandatory on POSIX/x64 since the interpreter doesn't save r12/r13.
+ * - The interpreter saves r12/r13 in its C frame, so if there is no foreign
+ *   code between the catch frame and the error, uj_throw unwinds without EXT
+ *   by jumping directly to the landing pads. EXT is still used otherwise.
  */
 
 /*
@@ -156,6 +156,14 @@ ERRDEF(BCBAD, "cannot load malformed bytecode")
 ERRDEF(SEAL_BADTYPE, "attempt to seal an object of unsupported type \"%s\"")
 ERRDEF(SEAL_FNUPVAL, "attempt to seal a function with upvalues")
 
+/* Serialization errors. */
+ERRDEF(SERIAL_BADTYPE,
+       "attempt to serialize an object of unsupported type \"%s\"")
+ERRDEF(SERIAL_FNUPVAL,
+       "attempt to serialize a C function or a function with upvalues")
+ERRDEF(SERIAL_DEPTH, "nesting of serialized tables is too deep")
+ERRDEF(SERIAL_BADDATA, "malformed serialized data")
+
 /* Immutability errors. */
 ERRDEF(IMMUT_BADTYPE,
        "attempt to make immutable an object of unsupported type \"%s\"")
@@ -182,6 +190,7 @@ ERRDEF(IPROF_ENABLED_JIT, "profiling cannot be proceeded with enabled JIT")
 
 /* ujit.string errors. */
 ERRDEF(SPLIT_EMPTY_SEPARATOR, "empty separator")
+ERRDEF(COUNT_EMPTY_SUBSTRING, "empty substring")
 
 #if LJ_HASFFI
 /* FFI errors. */
@@ -210,6 +219,8 @@ ERRDEF(FFI_BADCBACK, "bad callback")
 ERRDEF(FFI_CBACKOV, "too many callbacks")
 ERRDEF(FFI_NYIPACKBIT, "NYI: packed bit fields")
 ERRDEF(FFI_NYICALL, "NYI: cannot call this C function (yet)")
+ERRDEF(FFI_LOADDEF, "cannot load C types after declarations")
+ERRDEF(FFI_LOADBAD, "malformed C type data")
 #endif
 
 #undef ERRDEF
@@ -512,11 +512,10 @@ static void gdbjit_ehframe(struct gdb_jit_ctx *ctx)
 	DUV(&p, ctx, 4);
 	DB(&p, DW_CFA_offset | DW_REG_14);
 	DUV(&p, ctx, 5);
-	/* Extra registers saved for JIT-compiled code. */
 	DB(&p, DW_CFA_offset | DW_REG_13);
-	DUV(&p, ctx, 9);
+	DUV(&p, ctx, 6);
 	DB(&p, DW_CFA_offset | DW_REG_12);
-	DUV(&p, ctx, 10);
+	DUV(&p, ctx, 7);
 
 	/* Parent/interpreter stack frame size. */
 	if (ctx->spadjp != ctx->spadj) {
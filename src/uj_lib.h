@@ -177,6 +177,15 @@ static LJ_AINLINE GCudata *uj_lib_checkiofile(lua_State *L, unsigned int narg)
 	return udataV(tv);
 }
 
+static LJ_AINLINE GCudata *uj_lib_checkstrbuf(lua_State *L, unsigned int narg)
+{
+	const TValue *tv = uj_lib_narg2tv(L, narg);
+
+	if (!(tv < L->top && tvisstrbuf(tv)))
+		uj_err_argt(L, narg, LUA_TUSERDATA);
+	return udataV(tv);
+}
+
 GCtab *uj_lib_checktabornil(lua_State *L, unsigned int narg);
 
 int uj_lib_checkopt(lua_State *L, unsigned int narg, int def, const char *lst);
@@ -209,6 +218,11 @@ static LJ_AINLINE void uj_lib_pushcf(lua_State *L, lua_CFunction f, int id)
 struct RandomState;
 uint64_t lj_math_random_step(struct RandomState *rs);
 
+struct sbuf;
+void lj_string_format(lua_State *L, struct sbuf *sb, unsigned int arg);
+
+GCfunc *lj_ujit_string_splitter(lua_State *L, GCstr *sep);
+
 /* Userdata payload for I/O file. */
 struct IOFileUD {
 	FILE *fp; /* File handle. */
@@ -299,6 +299,82 @@ static const struct index_context mm_newindex = {.cont = lj_cont_nop,
 						 .mm = MM_newindex,
 						 .err = UJ_ERR_SETLOOP};
 
+/*
+ * Cache of __index resolutions for string keys. Class-style objects resolve
+ * methods and defaults through mt.__index, which is a table. An entry
+ * remembers the nodes where __index was found in mt and where the key was
+ * found in mt.__index, so that a repeated lookup of the same key through
+ * the same metatable costs two node checks instead of two hash chain walks.
+ * Entries are never invalidated explicitly: both nodes are re-validated on
+ * each hit against the current contents of the tables, so any store, rehash
+ * or metatable change simply makes the entry miss. Only a non-nil value
+ * found directly in mt.__index is cached, deeper levels of the chain are
+ * served by the entries of their own metatables.
+ */
+
+static LJ_AINLINE struct meta_icache_entry *meta_icache_entry(
+	global_State *g, const GCtab *mt, const GCstr *key)
+{
+	size_t hash = ((uintptr_t)mt >> 4) ^ key->hash;
+
+	return &g->meta_icache[hash & (META_ICACHE_SIZE - 1)];
+}
+
+static LJ_AINLINE const Node *meta_icache_node(const GCtab *t, uint32_t slot,
+					       const GCstr *key)
+{
+	const Node *n;
+
+	if (slot > t->hmask)
+		return NULL;
+
+	n = &t->node[slot];
+	if (!tvisstr(&n->key) || strV(&n->key) != key)
+		return NULL;
+
+	return n;
+}
+
+static const TValue *meta_icache_get(global_State *g, const GCtab *mt,
+				     const GCstr *key)
+{
+	const struct meta_icache_entry *e = meta_icache_entry(g, mt, key);
+	const Node *n;
+
+	if (e->mt != mt || e->key != key)
+		return NULL;
+
+	/* mt.__index must still be the same table... */
+	n = meta_icache_node(mt, e->mtslot, uj_meta_name(g, MM_index));
+	if (n == NULL || !tvistab(&n->val) || tabV(&n->val) != e->index)
+		return NULL;
+
+	/* ...and it must still hold a non-nil value for the key. */
+	n = meta_icache_node(e->index, e->slot, key);
+	if (n == NULL || tvisnil(&n->val))
+		return NULL;
+
+	return &n->val;
+}
+
+static void meta_icache_set(global_State *g, const GCtab *mt,
+			    const TValue *mtv, const GCtab *index,
+			    const GCstr *key, const TValue *v)
+{
+	struct meta_icache_entry *e = meta_icache_entry(g, mt, key);
+
+	/* Both values are taken from hash parts since the keys are strings. */
+	lua_assert(mtv >= &mt->node[0].val && mtv <= &mt->node[mt->hmask].val);
+	lua_assert(v >= &index->node[0].val &&
+		   v <= &index->node[index->hmask].val);
+
+	e->mt = mt;
+	e->key = key;
+	e->index = index;
+	e->mtslot = (uint32_t)((const Node *)mtv - mt->node);
+	e->slot = (uint32_t)((const Node *)v - index->node);
+}
+
 /*
  * Helper for TGET* and TSET*. __index/__newindex chain and metamethod.
  * Performs generic tv[k] lookup:
@@ -323,9 +399,14 @@ static TValue *meta_index(lua_State *L, const TValue *tv, const TValue *k,
 	int loop;
 	const ASMFunction cont = ctx->cont;
 	const enum MMS mm = ctx->mm;
+	const int cached = mm == MM_index && tvisstr(k);
+	const GCtab *prev_mt = NULL; /* Metatable tv was taken from, if any. */
+	const TValue *prev_mtv = NULL;
 
 	for (loop = 0; loop < LJ_MAX_IDXCHAIN; loop++) {
 		const TValue *mtv = NULL;
+		GCtab *mt;
+
 		if (tvistab(tv)) {
 			GCtab *t = tabV(tv);
 			TValue *v = (TValue *)lj_tab_get(L, t, k);
@@ -333,13 +414,32 @@ static TValue *meta_index(lua_State *L, const TValue *tv, const TValue *k,
 			if (!tvisnil(v)) {
 				if (mm == MM_newindex)
 					meta_store_mark(L, t);
+				else if (cached && prev_mt != NULL)
+					meta_icache_set(G(L), prev_mt, prev_mtv,
+							t, strV(k), v);
 				return v;
 			}
 
-			mtv = uj_meta_lookup_mt(G(L), t->metatable, mm);
+			mt = t->metatable;
+			if (cached && mt != NULL) {
+				const TValue *cv = meta_icache_get(G(L), mt,
+								   strV(k));
+				if (cv != NULL)
+					return (TValue *)cv;
+			}
+
+			mtv = uj_meta_lookup_mt(G(L), mt, mm);
 			if (mtv == NULL)
 				return meta_index_nomm(L, t, k, v, mm);
 		} else {
+			mt = uj_mtab_get(L, tv);
+			if (cached && mt != NULL) {
+				const TValue *cv = meta_icache_get(G(L), mt,
+								   strV(k));
+				if (cv != NULL)
+					return (TValue *)cv;
+			}
+
 			mtv = uj_meta_lookup(L, tv, mm);
 			if (tvisnil(mtv))
 				meta_err_optype(L, tv, UJ_ERR_OPINDEX);
@@ -351,6 +451,8 @@ static TValue *meta_index(lua_State *L, const TValue *tv, const TValue *k,
 			return NULL;
 		}
 
+		prev_mt = mt;
+		prev_mtv = mtv;
 		tv = mtv;
 	}
 	uj_err(L, ctx->err);
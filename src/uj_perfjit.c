@@ -0,0 +1,327 @@
+/*
+ * Emitting information about compiled traces for Linux perf.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ *
+ * Two formats are supported:
+ *
+ *  * perf map: A plain text file /tmp/perf-<pid>.map with lines
+ *    "<start> <size> <name>", which is picked up by perf report for samples
+ *    hitting anonymous executable memory.
+ *  * jitdump: A binary file /tmp/jit-<pid>.dump which contains machine code
+ *    of each trace, so that perf annotate works, too. The file is mmap'ed
+ *    with PROT_EXEC as a marker for perf record, samples are bound to the
+ *    traces with perf inject --jit. Timestamps are taken from
+ *    CLOCK_MONOTONIC, so perf record must be run with -k mono. perf looks
+ *    for exactly this file name, so it is opened once per process and
+ *    shared by all states emitting to it.
+ *
+ * Each trace is named after its number and its starting location.
+ */
+
+#include "lj_obj.h"
+
+#if LJ_HASJIT
+
+#include <elf.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef UJIT_IS_THREAD_SAFE
+#include <pthread.h>
+#endif /* UJIT_IS_THREAD_SAFE */
+
+#include "uj_mem.h"
+#include "uj_dispatch.h"
+#include "uj_proto.h"
+#include "uj_perfjit.h"
+#include "jit/lj_jit.h"
+
+#define PERFJIT_NAME_SIZE (FORMATTED_LOC_BUF_SIZE + 32)
+
+#define JITDUMP_MAGIC 0x4A695444 /* "JiTD" */
+#define JITDUMP_VERSION 1
+#define JITDUMP_CODE_LOAD 0
+#define JITDUMP_CODE_CLOSE 3
+
+struct jitdump_header {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t total_size;
+	uint32_t elf_mach;
+	uint32_t pad1;
+	uint32_t pid;
+	uint64_t timestamp;
+	uint64_t flags;
+};
+
+struct jitdump_record {
+	uint32_t id;
+	uint32_t total_size;
+	uint64_t timestamp;
+};
+
+/* Followed by the 0-terminated name and the machine code. */
+struct jitdump_code_load {
+	struct jitdump_record rec;
+	uint32_t pid;
+	uint32_t tid;
+	uint64_t vma;
+	uint64_t code_addr;
+	uint64_t code_size;
+	uint64_t code_index;
+};
+
+struct perfjit {
+	FILE *fp; /* jitdump only: Shared with other states of the process. */
+	enum perfjit_format format;
+};
+
+/* The jitdump file of the process. */
+static struct {
+	FILE *fp;
+	void *marker; /* Mapping of the file seen by perf. */
+	size_t szmarker;
+	uint64_t code_index; /* Unique id of each CODE_LOAD. */
+	unsigned int nusers; /* Number of states emitting to the file. */
+} jitdump;
+
+#ifdef UJIT_IS_THREAD_SAFE
+
+static pthread_mutex_t jitdump_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#define LOCK_JITDUMP() pthread_mutex_lock(&jitdump_mutex)
+#define UNLOCK_JITDUMP() pthread_mutex_unlock(&jitdump_mutex)
+
+#else /* UJIT_IS_THREAD_SAFE */
+
+#define LOCK_JITDUMP()
+#define UNLOCK_JITDUMP()
+
+#endif /* UJIT_IS_THREAD_SAFE */
+
+static uint64_t perfjit_timestamp(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+		return 0;
+
+	return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void perfjit_trace_name(char *name, const GCtrace *T)
+{
+	const GCproto *pt = T->startpt;
+	char loc[FORMATTED_LOC_BUF_SIZE];
+
+	uj_proto_sprintloc(loc, pt, proto_bcpos(pt, T->startpc));
+	sprintf(name, "TRACE_%u %s", (unsigned int)T->traceno, loc);
+}
+
+static void perfjit_emit_map(struct perfjit *pj, const GCtrace *T)
+{
+	char name[PERFJIT_NAME_SIZE];
+
+	perfjit_trace_name(name, T);
+	fprintf(pj->fp, "%lx %lx %s\n", (unsigned long)(uintptr_t)T->mcode,
+		(unsigned long)T->szmcode, name);
+}
+
+static void perfjit_emit_jitdump(struct perfjit *pj, const GCtrace *T)
+{
+	struct jitdump_code_load load;
+	char name[PERFJIT_NAME_SIZE];
+	size_t szname;
+
+	perfjit_trace_name(name, T);
+	szname = strlen(name) + 1;
+
+	load.rec.id = JITDUMP_CODE_LOAD;
+	load.rec.total_size = (uint32_t)(sizeof(load) + szname + T->szmcode);
+	load.rec.timestamp = perfjit_timestamp();
+	load.pid = (uint32_t)getpid();
+	load.tid = (uint32_t)syscall(SYS_gettid);
+	load.vma = (uint64_t)(uintptr_t)T->mcode;
+	load.code_addr = load.vma;
+	load.code_size = (uint64_t)T->szmcode;
+	load.code_index = jitdump.code_index++;
+
+	fwrite(&load, sizeof(load), 1, pj->fp);
+	fwrite(name, szname, 1, pj->fp);
+	fwrite(T->mcode, T->szmcode, 1, pj->fp);
+}
+
+/* Must be called with the jitdump file locked for the jitdump format. */
+static void perfjit_emit_locked(struct perfjit *pj, const GCtrace *T)
+{
+	if (pj->format == PERFJIT_FORMAT_JITDUMP)
+		perfjit_emit_jitdump(pj, T);
+	else
+		perfjit_emit_map(pj, T);
+
+	/* Keep the file consistent even if the process is killed. */
+	fflush(pj->fp);
+}
+
+static void perfjit_emit(struct perfjit *pj, const GCtrace *T)
+{
+	if (pj->format == PERFJIT_FORMAT_JITDUMP) {
+		LOCK_JITDUMP();
+		perfjit_emit_locked(pj, T);
+		UNLOCK_JITDUMP();
+	} else {
+		perfjit_emit_locked(pj, T);
+	}
+}
+
+/* Must be called with the jitdump file locked. */
+static int perfjit_open_jitdump(const char *fname)
+{
+	struct jitdump_header header;
+	long pagesize = sysconf(_SC_PAGESIZE);
+
+	if (jitdump.nusers > 0) {
+		jitdump.nusers++;
+		return 0;
+	}
+
+	/* A readable descriptor is needed for mmap. */
+	jitdump.fp = fopen(fname, "w+");
+	if (jitdump.fp == NULL)
+		return 1;
+
+	jitdump.szmarker = pagesize > 0 ? (size_t)pagesize : 4096;
+	jitdump.marker = mmap(NULL, jitdump.szmarker, PROT_READ | PROT_EXEC,
+			      MAP_PRIVATE, fileno(jitdump.fp), 0);
+	if (jitdump.marker == MAP_FAILED) {
+		fclose(jitdump.fp);
+		jitdump.fp = NULL;
+		jitdump.marker = NULL;
+		return 1;
+	}
+
+	memset(&header, 0, sizeof(header));
+	header.magic = JITDUMP_MAGIC;
+	header.version = JITDUMP_VERSION;
+	header.total_size = sizeof(header);
+	header.elf_mach = EM_X86_64;
+	header.pid = (uint32_t)getpid();
+	header.timestamp = perfjit_timestamp();
+
+	fwrite(&header, sizeof(header), 1, jitdump.fp);
+	jitdump.code_index = 0;
+	jitdump.nusers = 1;
+	return 0;
+}
+
+/* Must be called with the jitdump file locked. */
+static void perfjit_close_jitdump(void)
+{
+	struct jitdump_record rec;
+
+	lua_assert(jitdump.nusers > 0);
+	if (--jitdump.nusers > 0)
+		return;
+
+	rec.id = JITDUMP_CODE_CLOSE;
+	rec.total_size = sizeof(rec);
+	rec.timestamp = perfjit_timestamp();
+	fwrite(&rec, sizeof(rec), 1, jitdump.fp);
+
+	munmap(jitdump.marker, jitdump.szmarker);
+	fclose(jitdump.fp);
+	jitdump.fp = NULL;
+	jitdump.marker = NULL;
+}
+
+static void perfjit_close(global_State *g, struct perfjit *pj)
+{
+	if (pj->format == PERFJIT_FORMAT_JITDUMP) {
+		LOCK_JITDUMP();
+		perfjit_close_jitdump();
+		UNLOCK_JITDUMP();
+	} else {
+		fclose(pj->fp);
+	}
+
+	uj_mem_free(MEM_G(g), pj, sizeof(*pj));
+}
+
+int uj_perfjit_start(lua_State *L, enum perfjit_format format, char *fname)
+{
+	global_State *g = G(L);
+	jit_State *J = L2J(L);
+	struct perfjit *pj;
+	TraceNo i;
+
+	if (J->perfjit != NULL)
+		return 1;
+
+	pj = uj_mem_alloc(L, sizeof(*pj));
+	memset(pj, 0, sizeof(*pj));
+	pj->format = format;
+
+	if (format == PERFJIT_FORMAT_JITDUMP)
+		sprintf(fname, "/tmp/jit-%d.dump", (int)getpid());
+	else
+		sprintf(fname, "/tmp/perf-%d.map", (int)getpid());
+
+	if (format == PERFJIT_FORMAT_JITDUMP) {
+		LOCK_JITDUMP();
+		if (perfjit_open_jitdump(fname) != 0) {
+			UNLOCK_JITDUMP();
+			uj_mem_free(MEM_G(g), pj, sizeof(*pj));
+			return 1;
+		}
+		pj->fp = jitdump.fp;
+	} else {
+		pj->fp = fopen(fname, "a");
+		if (pj->fp == NULL) {
+			uj_mem_free(MEM_G(g), pj, sizeof(*pj));
+			return 1;
+		}
+	}
+
+	J->perfjit = pj;
+
+	for (i = 1; i < J->sizetrace; i++) {
+		const GCtrace *T = traceref(J, i);
+
+		if (T != NULL && T->mcode != NULL)
+			perfjit_emit_locked(pj, T);
+	}
+
+	if (format == PERFJIT_FORMAT_JITDUMP)
+		UNLOCK_JITDUMP();
+
+	return 0;
+}
+
+int uj_perfjit_stop(jit_State *J)
+{
+	if (J->perfjit == NULL)
+		return 1;
+
+	perfjit_close(J2G(J), J->perfjit);
+	J->perfjit = NULL;
+	return 0;
+}
+
+void uj_perfjit_addtrace(jit_State *J, const GCtrace *T)
+{
+	if (J->perfjit != NULL)
+		perfjit_emit(J->perfjit, T);
+}
+
+void uj_perfjit_updtrace(jit_State *J, const GCtrace *T)
+{
+	struct perfjit *pj = J->perfjit;
+
+	/* Address range of the trace is not changed, only the jitdump cares. */
+	if (pj != NULL && pj->format == PERFJIT_FORMAT_JITDUMP)
+		perfjit_emit(pj, T);
+}
+
+#endif /* LJ_HASJIT */
@@ -0,0 +1,52 @@
+/*
+ * Emitting information about compiled traces for Linux perf.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#ifndef _UJ_PERFJIT_H
+#define _UJ_PERFJIT_H
+
+#include "lj_def.h"
+#include "jit/lj_jit.h"
+
+#if LJ_HASJIT
+
+enum perfjit_format {
+	/* /tmp/perf-<pid>.map, read by perf report as is. */
+	PERFJIT_FORMAT_MAP,
+	/* /tmp/jit-<pid>.dump with machine code, see perf inject --jit. */
+	PERFJIT_FORMAT_JITDUMP
+};
+
+/*
+ * Start emitting information about traces of the compiler of L in the given
+ * format. All traces existing at the moment are emitted immediately. On
+ * success, returns 0 and stores the name of the file to fname (must be at
+ * least PERFJIT_FNAME_SIZE bytes long). Returns non-0 otherwise (e.g.
+ * emitting is already started).
+ */
+#define PERFJIT_FNAME_SIZE 64
+int uj_perfjit_start(lua_State *L, enum perfjit_format format, char *fname);
+
+/*
+ * Stop emitting information about traces. Returns 0 on success and non-0
+ * otherwise (e.g. nothing was actually emitted).
+ */
+int uj_perfjit_stop(jit_State *J);
+
+/*
+ * Emit information about a newly compiled trace T.
+ * To be called after the trace is successfully assembled and saved.
+ */
+void uj_perfjit_addtrace(jit_State *J, const GCtrace *T);
+
+/*
+ * Emit information about changed machine code of the trace T.
+ * To be called after the trace is patched.
+ */
+void uj_perfjit_updtrace(jit_State *J, const GCtrace *T);
+
+#endif /* LJ_HASJIT */
+
+#endif /* !_UJ_PERFJIT_H */
@@ -100,8 +100,14 @@ struct sbuf *uj_sbuf_push_numint(struct sbuf *sb, lua_Number n)
 	if (checki32(intnum))
 		return uj_sbuf_push_int(sb, intnum);
 
-	sbuf_fit(sb, LUAI_MAXNUMBER2STR);
-	sb->sz += sprintf(uj_sbuf_back(sb), "%" PRId64, intnum);
+	sbuf_fit(sb, 1 + UJ_CSTR_U64BUF);
+	if (intnum < 0) {
+		*uj_sbuf_back(sb) = '-';
+		sb->sz++;
+		sb->sz += uj_cstr_fromu64(uj_sbuf_back(sb), -(uint64_t)intnum);
+	} else {
+		sb->sz += uj_cstr_fromu64(uj_sbuf_back(sb), (uint64_t)intnum);
+	}
 	return sb;
 }
 
@@ -137,6 +143,13 @@ struct sbuf *uj_sbuf_push_uleb128(struct sbuf *sb, uint64_t value)
 	return sb;
 }
 
+struct sbuf *uj_sbuf_push_leb128(struct sbuf *sb, int64_t value)
+{
+	sbuf_fit(sb, LEB128_U64_MAXSIZE);
+	sb->sz += write_leb128((uint8_t *)uj_sbuf_back(sb), value);
+	return sb;
+}
+
 struct sbuf *uj_sbuf_push_block(struct sbuf *sb, const void *src, size_t n)
 {
 	sbuf_fit(sb, n);
@@ -95,6 +95,7 @@ struct sbuf *uj_sbuf_push_number(struct sbuf *sb, lua_Number n);
 /* Always converts number to integer type before pushing. */
 struct sbuf *uj_sbuf_push_numint(struct sbuf *sb, lua_Number n);
 struct sbuf *uj_sbuf_push_uleb128(struct sbuf *sb, uint64_t value);
+struct sbuf *uj_sbuf_push_leb128(struct sbuf *sb, int64_t value);
 struct sbuf *uj_sbuf_push_ptr(struct sbuf *sb, const void *ptr);
 struct sbuf *uj_sbuf_push_block(struct sbuf *sb, const void *src, size_t n);
 
@@ -0,0 +1,471 @@
+/*
+ * Binary serialization of Lua values.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ *
+ * Each value is encoded as a tag byte followed by a payload:
+ *
+ *  * NIL, FALSE, TRUE: no payload.
+ *  * INT: sleb128. Used for numbers with an exact int32 representation
+ *    (except -0).
+ *  * NUM: 8 bytes of a double, little-endian.
+ *  * STR: uleb128 length followed by the bytes of the string.
+ *  * TAB: uleb128 array size (slot 0 included, trailing nils trimmed),
+ *    uleb128 number of hash entries n, array part values, n pairs of keys
+ *    and values.
+ *  * FUNC: 4-byte little-endian length followed by the bytecode dump of the
+ *    prototype. Only with UJ_SERIAL_FUNC.
+ *  * REF: uleb128 index of a previously encoded string, table or function.
+ *
+ * Strings, tables and functions are indexed in the order of their first
+ * occurrence, so that shared references and cycles are restored and each
+ * distinct string is interned only once during decoding. Sizes from the
+ * stream are used to create tables of exactly the right size.
+ */
+
+#include "lj_obj.h"
+#include "lj_gc.h"
+#include "lj_tab.h"
+#include "lj_bcdump.h"
+#include "uj_err.h"
+#include "uj_sbuf.h"
+#include "uj_serial.h"
+#include "uj_state.h"
+#include "uj_str.h"
+#include "uj_throw.h"
+#include "utils/leb128.h"
+
+enum serial_tag {
+	SERIAL_NIL,
+	SERIAL_FALSE,
+	SERIAL_TRUE,
+	SERIAL_INT,
+	SERIAL_NUM,
+	SERIAL_STR,
+	SERIAL_TAB,
+	SERIAL_FUNC,
+	SERIAL_REF,
+	SERIAL__MAX
+};
+
+/* Limit for nesting of tables, protects the C stack. */
+#define SERIAL_MAXDEPTH 1000
+
+#define SERIAL_FUNCLEN_SIZE 4
+
+/* -- Encoding ------------------------------------------------------------- */
+
+struct serial_enc {
+	lua_State *L;
+	struct sbuf *sb;
+	GCtab *refs; /* Object -> its index, anchored on the stack. */
+	uint32_t nrefs;
+	uint32_t depth;
+	unsigned int flags;
+};
+
+static void serial_enc_value(struct serial_enc *ctx, const TValue *tv);
+
+/* Returns 1 if the object tv was already encoded and writes a reference. */
+static int serial_enc_ref(struct serial_enc *ctx, const TValue *tv)
+{
+	const TValue *idx = lj_tab_get(ctx->L, ctx->refs, tv);
+
+	if (!tvisnil(idx)) {
+		uj_sbuf_push_char(ctx->sb, SERIAL_REF);
+		uj_sbuf_push_uleb128(ctx->sb, (uint64_t)numV(idx));
+		return 1;
+	}
+
+	/* NOBARRIER: lj_tab_set handles the barrier for the key. */
+	setnumV(lj_tab_set(ctx->L, ctx->refs, tv), (lua_Number)ctx->nrefs);
+	ctx->nrefs++;
+	return 0;
+}
+
+static void serial_enc_num(struct serial_enc *ctx, const TValue *tv)
+{
+	lua_Number n = numV(tv);
+	int32_t k = lj_num2int(n);
+
+	if ((lua_Number)k == n && (k != 0 || rawV(tv) == 0)) {
+		uj_sbuf_push_char(ctx->sb, SERIAL_INT);
+		uj_sbuf_push_leb128(ctx->sb, k);
+	} else {
+		uj_sbuf_push_char(ctx->sb, SERIAL_NUM);
+		uj_sbuf_push_block(ctx->sb, &n, sizeof(n));
+	}
+}
+
+static void serial_enc_str(struct serial_enc *ctx, const TValue *tv)
+{
+	const GCstr *s = strV(tv);
+
+	if (serial_enc_ref(ctx, tv))
+		return;
+
+	uj_sbuf_push_char(ctx->sb, SERIAL_STR);
+	uj_sbuf_push_uleb128(ctx->sb, s->len);
+	uj_sbuf_push_str(ctx->sb, s);
+}
+
+static void serial_enc_tab(struct serial_enc *ctx, const TValue *tv)
+{
+	const GCtab *t = tabV(tv);
+	uint32_t asize = t->asize;
+	uint32_t nhash = 0;
+	uint32_t i;
+
+	if (serial_enc_ref(ctx, tv))
+		return;
+
+	if (++ctx->depth > SERIAL_MAXDEPTH)
+		uj_err(ctx->L, UJ_ERR_SERIAL_DEPTH);
+
+	while (asize > 0 && tvisnil(arrayslot(t, asize - 1)))
+		asize--;
+
+	if (t->hmask > 0) {
+		for (i = 0; i <= t->hmask; i++) {
+			if (!tvisnil(&t->node[i].val))
+				nhash++;
+		}
+	}
+
+	uj_sbuf_push_char(ctx->sb, SERIAL_TAB);
+	uj_sbuf_push_uleb128(ctx->sb, asize);
+	uj_sbuf_push_uleb128(ctx->sb, nhash);
+
+	for (i = 0; i < asize; i++)
+		serial_enc_value(ctx, arrayslot(t, i));
+
+	for (i = 0; nhash > 0 && i <= t->hmask; i++) {
+		const Node *n = &t->node[i];
+
+		if (tvisnil(&n->val))
+			continue;
+
+		serial_enc_value(ctx, &n->key);
+		serial_enc_value(ctx, &n->val);
+	}
+
+	ctx->depth--;
+}
+
+static int serial_writer(lua_State *L, const void *p, size_t sz, void *ud)
+{
+	UNUSED(L);
+	uj_sbuf_push_block((struct sbuf *)ud, p, sz);
+	return 0;
+}
+
+static void serial_enc_func(struct serial_enc *ctx, const TValue *tv)
+{
+	const GCfunc *fn = funcV(tv);
+	struct sbuf *sb = ctx->sb;
+	size_t start;
+	uint32_t len;
+
+	if (!isluafunc(fn) || funcproto(fn)->sizeuv != 0)
+		uj_err(ctx->L, UJ_ERR_SERIAL_FNUPVAL);
+
+	if (serial_enc_ref(ctx, tv))
+		return;
+
+	uj_sbuf_push_char(sb, SERIAL_FUNC);
+	start = uj_sbuf_size(sb);
+	uj_sbuf_push_block(sb, &len, SERIAL_FUNCLEN_SIZE); /* Patched below. */
+
+	lj_bcwrite(ctx->L, funcproto(fn), serial_writer, sb, 0);
+
+	len = (uint32_t)(uj_sbuf_size(sb) - start - SERIAL_FUNCLEN_SIZE);
+	memcpy(uj_sbuf_at(sb, start), &len, SERIAL_FUNCLEN_SIZE);
+}
+
+static void serial_enc_value(struct serial_enc *ctx, const TValue *tv)
+{
+	if (tvisnil(tv))
+		uj_sbuf_push_char(ctx->sb, SERIAL_NIL);
+	else if (tvisfalse(tv))
+		uj_sbuf_push_char(ctx->sb, SERIAL_FALSE);
+	else if (tvistrue(tv))
+		uj_sbuf_push_char(ctx->sb, SERIAL_TRUE);
+	else if (tvisnum(tv))
+		serial_enc_num(ctx, tv);
+	else if (tvisstr(tv))
+		serial_enc_str(ctx, tv);
+	else if (tvistab(tv))
+		serial_enc_tab(ctx, tv);
+	else if (tvisfunc(tv) && (ctx->flags & UJ_SERIAL_FUNC))
+		serial_enc_func(ctx, tv);
+	else
+		uj_err_callerv(ctx->L, UJ_ERR_SERIAL_BADTYPE, lj_typename(tv));
+}
+
+void uj_serial_encode(lua_State *L, struct sbuf *sb, const TValue *tv,
+		      unsigned int flags)
+{
+	struct serial_enc ctx;
+	TValue root;
+
+	/* tv may point to the stack, which is reallocated below. */
+	copyTV(L, &root, tv);
+
+	ctx.L = L;
+	ctx.sb = sb;
+	ctx.refs = lj_tab_new(L, 0, 0);
+	ctx.nrefs = 0;
+	ctx.depth = 0;
+	ctx.flags = flags;
+
+	settabV(L, L->top, ctx.refs);
+	uj_state_stack_incr_top(L);
+
+	serial_enc_value(&ctx, &root);
+
+	L->top--;
+}
+
+/* -- Decoding ------------------------------------------------------------- */
+
+struct serial_dec {
+	lua_State *L;
+	const uint8_t *p;
+	const uint8_t *end;
+	GCtab *refs; /* Index -> object, anchored on the stack. */
+	uint32_t nrefs;
+	uint32_t depth;
+	unsigned int flags;
+};
+
+static LJ_NORET void serial_dec_err(const struct serial_dec *ctx)
+{
+	uj_err(ctx->L, UJ_ERR_SERIAL_BADDATA);
+}
+
+static LJ_AINLINE size_t serial_dec_left(const struct serial_dec *ctx)
+{
+	return (size_t)(ctx->end - ctx->p);
+}
+
+static uint64_t serial_dec_uleb128(struct serial_dec *ctx)
+{
+	uint64_t v;
+	size_t n = read_uleb128_n(&v, ctx->p, serial_dec_left(ctx));
+
+	if (n == 0)
+		serial_dec_err(ctx);
+	ctx->p += n;
+	return v;
+}
+
+/* Reads a size which is guaranteed to consume at least one byte per unit. */
+static uint32_t serial_dec_size(struct serial_dec *ctx)
+{
+	uint64_t v = serial_dec_uleb128(ctx);
+
+	if (v > serial_dec_left(ctx))
+		serial_dec_err(ctx);
+	return (uint32_t)v;
+}
+
+static void serial_dec_addref(struct serial_dec *ctx, const TValue *tv)
+{
+	TValue *slot = lj_tab_setint(ctx->L, ctx->refs, (int32_t)ctx->nrefs);
+
+	copyTV(ctx->L, slot, tv);
+	lj_gc_barriert(ctx->L, ctx->refs, tv);
+	ctx->nrefs++;
+}
+
+static void serial_dec_value(struct serial_dec *ctx, TValue *tv);
+
+static void serial_dec_str(struct serial_dec *ctx, TValue *tv)
+{
+	uint32_t len = serial_dec_size(ctx);
+
+	setstrV(ctx->L, tv, uj_str_new(ctx->L, (const char *)ctx->p, len));
+	ctx->p += len;
+	serial_dec_addref(ctx, tv);
+}
+
+static void serial_dec_tab(struct serial_dec *ctx, TValue *tv)
+{
+	lua_State *L = ctx->L;
+	uint32_t asize = serial_dec_size(ctx);
+	uint32_t nhash = serial_dec_size(ctx);
+	GCtab *t;
+	uint32_t i;
+
+	if (asize > LJ_MAX_ASIZE || nhash > serial_dec_left(ctx) / 2)
+		serial_dec_err(ctx);
+
+	if (++ctx->depth > SERIAL_MAXDEPTH)
+		uj_err(L, UJ_ERR_SERIAL_DEPTH);
+
+	t = lj_tab_new(L, asize, hsize2hbits(nhash));
+	settabV(L, tv, t);
+	serial_dec_addref(ctx, tv);
+
+	for (i = 0; i < asize; i++) {
+		TValue *slot = arrayslot(t, i);
+
+		serial_dec_value(ctx, slot);
+		lj_gc_barriert(L, t, slot);
+	}
+
+	for (i = 0; i < nhash; i++) {
+		TValue key, val;
+
+		serial_dec_value(ctx, &key);
+		serial_dec_value(ctx, &val);
+		if (tvisnil(&key) || tvisnil(&val))
+			serial_dec_err(ctx);
+
+		if (tvisnum(&key)) {
+			if (tvisnan(&key))
+				serial_dec_err(ctx);
+			if (tvismzero(&key))
+				setnumV(&key, 0); /* Normalize -0 to +0. */
+		}
+
+		copyTV(L, lj_tab_set(L, t, &key), &val);
+		lj_gc_barriert(L, t, &val);
+	}
+
+	ctx->depth--;
+}
+
+struct serial_reader {
+	const uint8_t *p;
+	size_t len;
+};
+
+static const char *serial_reader(lua_State *L, void *ud, size_t *sz)
+{
+	struct serial_reader *rd = (struct serial_reader *)ud;
+	const char *p = (const char *)rd->p;
+
+	UNUSED(L);
+	*sz = rd->len;
+	rd->p = NULL;
+	rd->len = 0;
+	return p;
+}
+
+static void serial_dec_func(struct serial_dec *ctx, TValue *tv)
+{
+	lua_State *L = ctx->L;
+	struct serial_reader rd;
+	uint32_t len;
+	int status;
+
+	if (serial_dec_left(ctx) < SERIAL_FUNCLEN_SIZE)
+		serial_dec_err(ctx);
+	memcpy(&len, ctx->p, SERIAL_FUNCLEN_SIZE);
+	ctx->p += SERIAL_FUNCLEN_SIZE;
+	if (len == 0 || len > serial_dec_left(ctx) || *ctx->p != BCDUMP_HEAD1)
+		serial_dec_err(ctx);
+
+	rd.p = ctx->p;
+	rd.len = len;
+	ctx->p += len;
+
+	uj_state_stack_check(L, 1);
+	status = lua_loadx(L, serial_reader, &rd, "=(serialized)", "b");
+	if (status != 0)
+		uj_throw(L, status);
+
+	copyTV(L, tv, L->top - 1);
+	L->top--;
+	serial_dec_addref(ctx, tv);
+}
+
+static void serial_dec_ref(struct serial_dec *ctx, TValue *tv)
+{
+	uint64_t idx = serial_dec_uleb128(ctx);
+
+	if (idx >= ctx->nrefs)
+		serial_dec_err(ctx);
+	copyTV(ctx->L, tv, lj_tab_getint(ctx->refs, (int32_t)idx));
+}
+
+static void serial_dec_value(struct serial_dec *ctx, TValue *tv)
+{
+	if (ctx->p >= ctx->end)
+		serial_dec_err(ctx);
+
+	switch (*ctx->p++) {
+	case SERIAL_NIL:
+		setnilV(tv);
+		break;
+	case SERIAL_FALSE:
+		setboolV(tv, 0);
+		break;
+	case SERIAL_TRUE:
+		setboolV(tv, 1);
+		break;
+	case SERIAL_INT: {
+		int64_t k;
+		size_t n = read_leb128_n(&k, ctx->p, serial_dec_left(ctx));
+
+		if (n == 0 || k != (int32_t)k)
+			serial_dec_err(ctx);
+		ctx->p += n;
+		setnumV(tv, (lua_Number)k);
+		break;
+	}
+	case SERIAL_NUM: {
+		lua_Number n;
+
+		if (serial_dec_left(ctx) < sizeof(n))
+			serial_dec_err(ctx);
+		memcpy(&n, ctx->p, sizeof(n));
+		ctx->p += sizeof(n);
+		setnumV(tv, n);
+		break;
+	}
+	case SERIAL_STR:
+		serial_dec_str(ctx, tv);
+		break;
+	case SERIAL_TAB:
+		serial_dec_tab(ctx, tv);
+		break;
+	case SERIAL_FUNC:
+		if (!(ctx->flags & UJ_SERIAL_FUNC))
+			serial_dec_err(ctx);
+		serial_dec_func(ctx, tv);
+		break;
+	case SERIAL_REF:
+		serial_dec_ref(ctx, tv);
+		break;
+	default:
+		serial_dec_err(ctx);
+	}
+}
+
+void uj_serial_decode(lua_State *L, const uint8_t *buf, size_t len,
+		      unsigned int flags)
+{
+	struct serial_dec ctx;
+	TValue tv;
+
+	ctx.L = L;
+	ctx.p = buf;
+	ctx.end = buf + len;
+	ctx.refs = lj_tab_new(L, 0, 0);
+	ctx.nrefs = 0;
+	ctx.depth = 0;
+	ctx.flags = flags;
+
+	settabV(L, L->top, ctx.refs);
+	uj_state_stack_incr_top(L);
+
+	/* Stack may be reallocated while loading functions, decode off-stack. */
+	serial_dec_value(&ctx, &tv);
+	if (ctx.p != ctx.end)
+		serial_dec_err(&ctx);
+
+	/* refs is replaced with the result. */
+	copyTV(L, L->top - 1, &tv);
+}
@@ -0,0 +1,40 @@
+/*
+ * Binary serialization of Lua values.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#ifndef _UJ_SERIAL_H
+#define _UJ_SERIAL_H
+
+#include "lj_obj.h"
+
+/* Header of data state images, see luaE_savedataroot. */
+#define UJ_SERIAL_IMAGE_MAGIC "\033UJD\001"
+#define UJ_SERIAL_IMAGE_MAGIC_SIZE (sizeof(UJ_SERIAL_IMAGE_MAGIC) - 1)
+
+/*
+ * Allow Lua functions without upvalues, which are stored as bytecode. Such
+ * data must come from a trusted source only, as bytecode is not verified.
+ */
+#define UJ_SERIAL_FUNC 0x1
+
+/*
+ * Appends serialized representation of the value tv to sb. Supported values
+ * are nil, booleans, numbers, strings, tables and, if allowed by flags, Lua
+ * functions. Shared references and cycles are preserved, each distinct string
+ * is written only once. Metatables are not serialized. Throws on unsupported
+ * values.
+ */
+void uj_serial_encode(lua_State *L, struct sbuf *sb, const TValue *tv,
+		      unsigned int flags);
+
+/*
+ * Deserializes a value from the buffer buf of size len and pushes it onto
+ * the stack of L. Functions are loaded with the globals of L as environment.
+ * Throws if the buffer is malformed or contains values not allowed by flags.
+ */
+void uj_serial_decode(lua_State *L, const uint8_t *buf, size_t len,
+		      unsigned int flags);
+
+#endif /* !_UJ_SERIAL_H */
@@ -480,6 +480,8 @@ lua_State *uj_state_newstate(const struct luae_Options *opt)
 	g->coverage = NULL;
 #endif /* UJIT_COVERAGE */
 	g->enable_itern = opt != NULL ? !opt->disableitern : 1;
+	g->enable_bcopt = opt != NULL ? opt->enablebcopt : 0;
+	g->enable_superins = opt != NULL ? opt->enablesuperins : 0;
 
 	/*
 	 * Just an extra check that some fields that are supposed to stay
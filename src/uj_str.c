@@ -15,6 +15,7 @@
 #include "uj_mem.h"
 #include "uj_err.h"
 #include "uj_str.h"
+#include "uj_cstr.h"
 #include "uj_sbuf.h"
 #include "uj_strhash.h"
 #include "uj_state.h"
@@ -414,6 +415,35 @@ GCstr *uj_str_trim(lua_State *L, const GCstr *str)
 	return uj_str_new(L, strdata(str) + left, (right - left + 1));
 }
 
+int uj_str_startswith(const GCstr *str, const GCstr *prefix)
+{
+	return prefix->len <= str->len &&
+	       memcmp(strdata(str), strdata(prefix), prefix->len) == 0;
+}
+
+int uj_str_endswith(const GCstr *str, const GCstr *suffix)
+{
+	return suffix->len <= str->len &&
+	       memcmp(strdata(str) + str->len - suffix->len, strdata(suffix),
+		      suffix->len) == 0;
+}
+
+size_t uj_str_count(const GCstr *str, const GCstr *sub)
+{
+	const char *p = strdata(str);
+	const char *end = p + str->len;
+	size_t n = 0;
+
+	lua_assert(sub->len > 0);
+	while ((p = uj_cstr_find(p, strdata(sub), (size_t)(end - p),
+				 sub->len)) != NULL) {
+		n++;
+		p += sub->len;
+	}
+
+	return n;
+}
+
 /* -- String concatenation for JIT-compiled code -------------------------- */
 
 #if LJ_HASJIT
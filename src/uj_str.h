@@ -100,6 +100,15 @@ TValue *uj_str_cat_step(lua_State *L, TValue *bottom, TValue *top);
 /* Removes whitespace from both ends of a string. */
 GCstr *uj_str_trim(lua_State *L, const GCstr *str);
 
+/* Checks whether str starts with prefix. */
+int uj_str_startswith(const GCstr *str, const GCstr *prefix);
+
+/* Checks whether str ends with suffix. */
+int uj_str_endswith(const GCstr *str, const GCstr *suffix);
+
+/* Counts non-overlapping occurrences of a non-empty sub in str. */
+size_t uj_str_count(const GCstr *str, const GCstr *sub);
+
 #if LJ_HASJIT
 
 /* Helper interface to concatenate strings during IR folding. */
@@ -0,0 +1,49 @@
+/*
+ * String buffer objects exposed to Lua as ujit.string.buffer.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#include "uj_strbuf.h"
+#include "uj_sbuf.h"
+
+void uj_strbuf_free(lua_State *L, GCudata *ud)
+{
+	struct sbuf *sb = uj_strbuf_sbuf(ud);
+
+	uj_sbuf_free(L, sb);
+	uj_sbuf_init(L, sb); /* The buffer may be resurrected by a finalizer. */
+}
+
+static LJ_AINLINE struct sbuf *strbuf_bind(lua_State *L, struct sbuf *sb)
+{
+	sb->L = L;
+	return sb;
+}
+
+struct sbuf *uj_strbuf_put_str(lua_State *L, struct sbuf *sb, const GCstr *s)
+{
+	return uj_sbuf_push_str(strbuf_bind(L, sb), s);
+}
+
+struct sbuf *uj_strbuf_put_int(lua_State *L, struct sbuf *sb, int32_t n)
+{
+	return uj_sbuf_push_int(strbuf_bind(L, sb), n);
+}
+
+struct sbuf *uj_strbuf_put_number(lua_State *L, struct sbuf *sb,
+				  lua_Number n)
+{
+	return uj_sbuf_push_number(strbuf_bind(L, sb), n);
+}
+
+struct sbuf *uj_strbuf_put_numint(lua_State *L, struct sbuf *sb,
+				  lua_Number n)
+{
+	return uj_sbuf_push_numint(strbuf_bind(L, sb), n);
+}
+
+void uj_strbuf_reset(struct sbuf *sb)
+{
+	uj_sbuf_reset(sb);
+}
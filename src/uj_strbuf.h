@@ -0,0 +1,44 @@
+/*
+ * String buffer objects exposed to Lua as ujit.string.buffer.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#ifndef _UJ_STRBUF_H
+#define _UJ_STRBUF_H
+
+#include "lj_obj.h"
+
+/*
+ * A string buffer is a userdata of type UDTYPE_STR_BUF with struct sbuf as
+ * the payload. Only the final string is interned, appending to the buffer
+ * creates no garbage.
+ */
+
+static LJ_AINLINE struct sbuf *uj_strbuf_sbuf(const GCudata *ud)
+{
+	lua_assert(ud->udtype == UDTYPE_STR_BUF);
+	return (struct sbuf *)uddata(ud);
+}
+
+/* Releases the storage of the buffer, called on finalization. */
+void uj_strbuf_free(lua_State *L, GCudata *ud);
+
+/*
+ * Interfaces below bind the buffer to `L` before appending, as the buffer
+ * may outlive the coroutine it was created in. They are called from traces,
+ * too, so they return the buffer for convenience of IR chaining.
+ */
+
+struct sbuf *uj_strbuf_put_str(lua_State *L, struct sbuf *sb, const GCstr *s);
+struct sbuf *uj_strbuf_put_int(lua_State *L, struct sbuf *sb, int32_t n);
+/* Appends a number the same way tostring converts it. */
+struct sbuf *uj_strbuf_put_number(lua_State *L, struct sbuf *sb,
+				  lua_Number n);
+/* Always converts number to integer type before appending. */
+struct sbuf *uj_strbuf_put_numint(lua_State *L, struct sbuf *sb,
+				  lua_Number n);
+
+void uj_strbuf_reset(struct sbuf *sb);
+
+#endif /* !_UJ_STRBUF_H */
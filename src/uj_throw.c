@@ -8,12 +8,18 @@
 #include "uj_throw.h"
 #include "uj_errmsg.h"
 #include "uj_unwind_ext.h"
+#include "uj_unwind.h"
 #include "lj_frame.h"
+#include "lj_vm.h"
 #include "uj_cframe.h"
 #include "uj_state.h"
 #include "uj_vmstate.h"
 #include "jit/lj_trace.h"
 
+#if LJ_HASFFI
+#include "uj_ff.h"
+#endif /* LJ_HASFFI */
+
 #include "lextlib.h"
 
 /* No error function (aka error handler) found + stop looking for it. */
@@ -29,6 +35,92 @@ static LJ_AINLINE uint64_t throw_uexclass_make(int errcode)
 
 static __thread struct _Unwind_Exception static_uex = {0};
 
+#if LJ_HASFFI
+/*
+ * Returns non-zero if foreign code called via FFI may be located on the host
+ * stack below the throw point: either the error is thrown during an FFI call,
+ * or a callback invoked by foreign code is being executed. Guest frames are
+ * scanned down to the nearest catch frame or C frame.
+ */
+static int throw_ffi_active(const lua_State *L)
+{
+	const TValue *frame = L->base - 1;
+
+	while (frame > L->stack) {
+		const uint8_t type = (uint8_t)frame_typep(frame);
+
+		if (type == FRAME_CONT && frame_is_cont_ffi_cb(frame))
+			return 1;
+
+		if (frame_func(frame)->c.ffid == FF_ffi_meta___call)
+			return 1;
+
+		if (type == FRAME_C || type == FRAME_CP || type == FRAME_PCALL ||
+		    type == FRAME_PCALLH)
+			break;
+
+		frame = frame_prev(frame);
+	}
+
+	return 0;
+}
+#endif /* LJ_HASFFI */
+
+/*
+ * Returns non-zero if the error can be caught without the external unwinder,
+ * i.e. if the catch frame belongs to the topmost C frame of the VM and there
+ * is no foreign code on the host stack between this C frame and uj_throw.
+ * The VM saves all callee-saved registers in its C frame and our own code
+ * never needs any cleanup, so the host stack can be simply discarded.
+ */
+static int throw_is_fast(const lua_State *L, int errcode)
+{
+	const void *cframe = L->cframe;
+	void *target;
+
+	/* Timeouts and yields are caught only by vm_resume, see uj_unwind.c. */
+	if (errcode == LUAE_TIMEOUT || errcode == LUA_YIELD)
+		return 0;
+
+	/* Hooks are called by the VM without creating a new C frame. */
+	if (cframe == NULL || hook_active(G(L)))
+		return 0;
+
+	/* vm_cpcall runs arbitrary C code, e.g. readers passed to lua_load. */
+	if (uj_cframe_nres(uj_cframe_raw(cframe)) < 0)
+		return 0;
+
+	/*
+	 * User C functions are called by the VM without a new C frame, too.
+	 * NB! Dummy frames are also reported as C functions.
+	 */
+	if (iscfunc(curr_func(L)))
+		return 0;
+
+#if LJ_HASFFI
+	/* Foreign code may need cleanup, e.g. run C++ destructors. */
+	if (throw_ffi_active(L))
+		return 0;
+#endif /* LJ_HASFFI */
+
+	target = uj_unwind_search((lua_State *)L, errcode,
+				  uj_cframe_raw(cframe));
+	return target != NULL && target != (void *)L;
+}
+
+/* Unwind both stacks and jump directly to the landing pad in the VM. */
+static LJ_NORET void throw_fast(struct lua_State *L, int errcode)
+{
+	void *cframe = uj_unwind_cleanup(L, errcode, uj_cframe_raw(L->cframe));
+
+	lua_assert(cframe != NULL);
+
+	if (uj_cframe_unwind_is_ff(cframe))
+		lj_vm_unwind_ff(cframe);
+
+	lj_vm_unwind_c(uj_cframe_raw(cframe), errcode);
+}
+
 LJ_NOINLINE void uj_throw(struct lua_State *L, int errcode)
 {
 	global_State *g = G(L);
@@ -43,6 +135,9 @@ LJ_NOINLINE void uj_throw(struct lua_State *L, int errcode)
 	 */
 	uj_vmstate_set(&g->vmstate, UJ_VMST_INTERP);
 
+	if (throw_is_fast(L, errcode))
+		throw_fast(L, errcode);
+
 	static_uex.exclass = throw_uexclass_make(errcode);
 	static_uex.excleanup = NULL;
 	_Unwind_RaiseException(&static_uex);
@@ -9,7 +9,10 @@
 
 #ifdef UJIT_TIMER
 
+#include <errno.h>
+#include <pthread.h>
 #include <signal.h>
+#include <time.h>
 
 #include "lj_def.h"
 #include "uj_sigtimer.h"
@@ -18,11 +21,18 @@
 
 #define TIMERINT_IS_TICKING (0x1)
 #define TIMERINT_DEFAULT_INIT (0x2)
+#define TIMERINT_THREAD (0x4)
 
+/*
+ * Ticks are written either by the signal handler or by the ticker thread and
+ * read by all threads running VMs, so the counter gets a cache line of its own.
+ */
 struct timerint {
-	uint64_t ticks;
-	uint64_t flags;
+	uint64_t ticks LJ_ALIGN(64);
+	uint64_t flags LJ_ALIGN(64);
+	int stop; /* Ticker thread must exit. */
 	struct sigtimer timer;
+	pthread_t ticker;
 };
 
 static struct timerint timerint;
@@ -35,6 +45,73 @@ static LJ_NOINLINE void timerint_handler(int sig, siginfo_t *si, void *context)
 	(timerint.ticks)++;
 }
 
+static uint64_t timerint_elapsed_usec(const struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)(now.tv_sec - start->tv_sec) * 1000000 +
+	       (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/*
+ * Ticks are derived from the monotonic clock rather than counted, so they do
+ * not lag behind if the thread is descheduled for a while.
+ */
+static void *timerint_ticker(void *arg)
+{
+	struct timespec start;
+	struct timespec next;
+
+	UNUSED(arg);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	next = start;
+
+	while (!__atomic_load_n(&timerint.stop, __ATOMIC_RELAXED)) {
+		next.tv_nsec += TIMERINT_INTERVAL_USEC * 1000;
+		while (next.tv_nsec >= 1000000000) {
+			next.tv_nsec -= 1000000000;
+			next.tv_sec++;
+		}
+
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next,
+				       NULL) == EINTR)
+			;
+
+		__atomic_store_n(&timerint.ticks,
+				 uj_timerint_to_ticks(
+					 timerint_elapsed_usec(&start)),
+				 __ATOMIC_RELAXED);
+	}
+
+	return NULL;
+}
+
+static int timerint_thread_start(void)
+{
+	sigset_t all;
+	sigset_t old;
+	int status;
+
+	timerint.stop = 0;
+
+	/* Process-directed signals must not be delivered to the ticker. */
+	sigfillset(&all);
+	pthread_sigmask(SIG_SETMASK, &all, &old);
+	status = pthread_create(&timerint.ticker, NULL, timerint_ticker, NULL);
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+	return status == 0 ? LUAE_INT_SUCCESS : LUAE_INT_ERR;
+}
+
+static int timerint_thread_stop(void)
+{
+	__atomic_store_n(&timerint.stop, 1, __ATOMIC_RELAXED);
+	return pthread_join(timerint.ticker, NULL) == 0 ? LUAE_INT_SUCCESS :
+							  LUAE_INT_ERR;
+}
+
 int uj_timerint_is_ticking(void)
 {
 	return timerint.flags & TIMERINT_IS_TICKING;
@@ -50,6 +127,16 @@ int uj_timerint_init(int signo)
 	if (uj_timerint_is_ticking())
 		return LUAE_INT_ERR;
 
+	if (signo == LUAE_INT_THREAD) {
+		timerint.ticks = 0;
+
+		if (timerint_thread_start() != LUAE_INT_SUCCESS)
+			return LUAE_INT_ERR;
+
+		timerint.flags |= TIMERINT_IS_TICKING | TIMERINT_THREAD;
+		return LUAE_INT_SUCCESS;
+	}
+
 	if (uj_sigtimer_init(timer, &opt) != SIGTIMER_SUCCESS)
 		return LUAE_INT_ERR;
 
@@ -84,6 +171,14 @@ int uj_timerint_terminate(void)
 	if (!uj_timerint_is_ticking())
 		return LUAE_INT_ERR;
 
+	if (timerint.flags & TIMERINT_THREAD) {
+		if (timerint_thread_stop() != LUAE_INT_SUCCESS)
+			return LUAE_INT_ERR;
+
+		timerint.flags &= ~(TIMERINT_IS_TICKING | TIMERINT_THREAD);
+		return LUAE_INT_SUCCESS;
+	}
+
 	if (uj_sigtimer_stop(timer) != SIGTIMER_SUCCESS)
 		return LUAE_INT_ERR;
 
@@ -112,7 +207,7 @@ int uj_timerint_terminate_default(void)
 
 uint64_t uj_timerint_ticks(void)
 {
-	return timerint.ticks;
+	return __atomic_load_n(&timerint.ticks, __ATOMIC_RELAXED);
 }
 
 #else /* UJIT_TIMER */
@@ -1,5 +1,6 @@
 /*
- * uJIT timer interrupts. Interrupts are delivered via a configurable signal.
+ * uJIT timer interrupts. Interrupts are delivered via a configurable signal
+ * or counted by a dedicated ticker thread.
  * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
  * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
  */
@@ -17,7 +18,9 @@ LJ_STATIC_ASSERT(TIMERINT_INTERVAL_USEC > 0);
 
 /*
  * Initializes interrupts. Interrupts are delivered to the application via
- * the signo signal. Returns LUAE_INT_SUCCESS on success, LUAE_INT_ERR otherwise.
+ * the signo signal. If signo is LUAE_INT_THREAD, no signal is used, ticks are
+ * updated by a dedicated thread instead.
+ * Returns LUAE_INT_SUCCESS on success, LUAE_INT_ERR otherwise.
  * An attempt to initialize interrupts more than once in a row is an error.
  */
 int uj_timerint_init(int signo);
@@ -8,6 +8,8 @@
  * starting with 4.8 documented __builtin_cpu_supports is used.
  */
 
+#include <cpuid.h>
+
 #include "cpuinfo.h"
 
 #ifndef __GNUC__
@@ -20,7 +22,6 @@
 
 #if __GNUC__ < 4 || \
   ( __GNUC__ == 4 && __GNUC_MINOR < 8)
-#include <cpuid.h>
 
 int cpuinfo_has_cmov(void) {
   unsigned int eax, ebx, ecx, edx;
@@ -73,3 +74,15 @@ int cpuinfo_has_sse4_1(void) {
 }
 #endif
 
+/* Extension below is queried with CPUID directly, as not all supported
+** GCC versions know it in __builtin_cpu_supports.
+*/
+
+int cpuinfo_has_bmi2(void) {
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid_max(0, (unsigned int *)0) < 7) {
+    return 0;
+  }
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  return ((ebx >> 8) & 1);
+}
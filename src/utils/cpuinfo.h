@@ -21,4 +21,7 @@ int cpuinfo_has_sse3(void);
 /* Returns non-zero if SSE 4.1 is supported. Returns 0 otherwise. */
 int cpuinfo_has_sse4_1(void);
 
+/* Returns non-zero if BMI2 (SHLX, SARX, SHRX, RORX etc.) is supported. Returns 0 otherwise. */
+int cpuinfo_has_bmi2(void);
+
 #endif /* !_UJIT_UTILS_CPUINFO_H_ */
@@ -95,7 +95,7 @@ static size_t _read_leb128(int64_t *out, const uint8_t *buffer, int guarded, siz
   }
 
   if (octet & LEB_SIGN_BIT && shift < sizeof(int64_t) * 8) {
-    value |= -(1 << shift);
+    value |= -((int64_t)1 << shift);
   }
 
   *out = value;
@@ -169,6 +169,33 @@ static StrScanFmt strscan_oct(const uint8_t *p, FpConv *o,
   return fmt;
 }
 
+/*
+** Fast path for decimal numbers like "1.5" or "25e-3". If the mantissa has
+** at most 15 digits and the decimal exponent is at most 22 in magnitude,
+** both are exactly representable as doubles and the result of a single
+** multiplication or division is correctly rounded (Clinger's fast path).
+*/
+#define STRSCAN_FASTDIG 15
+#define STRSCAN_FASTEXP 22
+
+static const double strscan_pow10[STRSCAN_FASTEXP+1] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static void strscan_fastdec(const uint8_t *p, FpConv *o,
+                            int32_t ex10, int32_t neg, uint32_t dig) {
+  uint64_t x = 0;
+  double n;
+  for ( ; dig > 0; dig--, p++) {
+    if (*p == '.') { p++; }
+    x = x * 10 + (*p & 15);
+  }
+  n = (double)(int64_t)x;
+  if (ex10 < 0) { n /= strscan_pow10[-ex10]; } else { n *= strscan_pow10[ex10]; }
+  o->d = neg ? -n : n;
+}
+
 /* Parse decimal number. */
 static StrScanFmt strscan_dec(const uint8_t *p, FpConv *o,
             StrScanFmt fmt, uint32_t opt,
@@ -458,6 +485,13 @@ StrScanFmt strscan_tonumber(const uint8_t *p, double *d, uint32_t opt) {
       }
     }
 
+    /* Fast path for decimal numbers with short mantissa and exponent. */
+    if (fmt == STRSCAN_NUM && base != 16 && dig != 0 &&
+        dig <= STRSCAN_FASTDIG && ex >= -STRSCAN_FASTEXP && ex <= STRSCAN_FASTEXP) {
+      strscan_fastdec(sp, o, ex, neg, dig);
+      return fmt;
+    }
+
     /* Dispatch to base-specific parser. */
     if (base == 0 && !(fmt == STRSCAN_NUM || fmt == STRSCAN_IMAG)) {
       return strscan_oct(sp, o, fmt, neg, dig);
@@ -30,3 +30,15 @@ do --- some tables as keys in tables
   end
   assert(n == 10)
 end
+
+do --- boolean keys in slots which held -0 before
+  local t = {}
+  for i = 1, 3 do
+    local k = -0.0
+    k = (i > 0)
+    t[k] = i
+  end
+  local n = 0
+  for k in pairs(t) do n = n + 1 end
+  assert(n == 1 and t[true] == 3 and t[0] == nil)
+end
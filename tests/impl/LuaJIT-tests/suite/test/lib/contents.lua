@@ -163,7 +163,7 @@ do --- bit +bit
 end
 
 do --- ffi +ffi
-  check(require"ffi", "C:abi:alignof:arch:cast:cdef:copy:errno:fill:gc:istype:load:metatype:new:offsetof:os:sizeof:string:typeof", "typeinfo")
+  check(require"ffi", "C:abi:alignof:arch:cast:cdef:copy:errno:fill:gc:istype:load:loadtypes:metatype:new:offsetof:os:savetypes:sizeof:string:typeof", "typeinfo")
 end
 
 do --- ffi 2.1 +fii +luajit>=2.1
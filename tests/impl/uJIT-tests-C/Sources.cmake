@@ -45,11 +45,13 @@ list(APPEND SUITE_SOURCES
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_lua_timeout.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_lua_yield.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_createstate.c
+ ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_dataimage.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_deepcopy.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_immutable.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_iterate.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_requiref.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_seal.c
+ ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_serialize.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_luae_table.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_math_fold.c
  ${CMAKE_CURRENT_SOURCE_DIR}/suite/test_profiler.c
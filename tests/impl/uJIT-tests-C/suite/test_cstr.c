@@ -4,6 +4,7 @@
  * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -38,6 +39,87 @@ static void test_cstr_fromint(void **state)
 		assert_fromint_vs_sprintf(i);
 }
 
+static void test_cstr_fromu64(void **state)
+{
+	UNUSED_STATE(state);
+
+	char buf1[UJ_CSTR_U64BUF + 1]; /* extra byte for ending '\0' */
+	char buf2[UJ_CSTR_U64BUF + 1];
+	uint64_t u;
+	size_t size;
+
+	for (u = 1; u != 0; u = u * 3 + 1) {
+		size = uj_cstr_fromu64(buf1, u);
+		buf1[size] = '\0';
+		sprintf(buf2, "%" PRIu64, u);
+		assert_string_equal(buf1, buf2);
+		if (u > UINT64_MAX / 3)
+			break;
+	}
+
+	size = uj_cstr_fromu64(buf1, UINT64_MAX);
+	buf1[size] = '\0';
+	assert_string_equal(buf1, "18446744073709551615");
+}
+
+static void assert_fromnum_vs_sprintf(lua_Number n)
+{
+	static const int precs[] = {1, 6, 14, 17};
+	char buf1[UJ_CSTR_NUMBUF + 1]; /* extra byte for ending '\0' */
+	char buf2[UJ_CSTR_NUMBUF + 1];
+	size_t size;
+	size_t i;
+
+	if (!isfinite(n))
+		return;
+
+	size = uj_cstr_fromnum(buf1, n);
+	buf1[size] = '\0';
+	sprintf(buf2, "%.14g", n);
+	assert_string_equal(buf1, buf2);
+
+	for (i = 0; i < sizeof(precs) / sizeof(precs[0]); i++) {
+		size = uj_cstr_fromnumg(buf1, n, precs[i]);
+		buf1[size] = '\0';
+		sprintf(buf2, "%.*g", precs[i], n);
+		assert_string_equal(buf1, buf2);
+	}
+}
+
+static void test_cstr_fromnum_vs_sprintf(void **state)
+{
+	UNUSED_STATE(state);
+
+	int i, exp;
+
+	for (exp = -320; exp <= 308; exp++) {
+		for (i = 1; i < 100; i += 7) {
+			lua_Number n = i * pow(10, exp) / 7;
+
+			assert_fromnum_vs_sprintf(n);
+			assert_fromnum_vs_sprintf(-n);
+			assert_fromnum_vs_sprintf(i * pow(10, exp));
+		}
+	}
+
+	/* Ties, rounding to the next power of 10, switching the notation: */
+	for (i = 1; i < 4096; i++)
+		assert_fromnum_vs_sprintf(i / 4096.0);
+	assert_fromnum_vs_sprintf(0.125);
+	assert_fromnum_vs_sprintf(99999999999999.5);
+	assert_fromnum_vs_sprintf(999999999999995.0);
+	assert_fromnum_vs_sprintf(9.99999999999995e-5);
+	assert_fromnum_vs_sprintf(1e14);
+	assert_fromnum_vs_sprintf(1e14 - 1);
+	assert_fromnum_vs_sprintf(0.0001);
+	assert_fromnum_vs_sprintf(0.00001);
+	assert_fromnum_vs_sprintf(9007199254740993.0);
+	assert_fromnum_vs_sprintf(-2147483648.0);
+	assert_fromnum_vs_sprintf(2147483648.0);
+	assert_fromnum_vs_sprintf(1.7976931348623157e308);
+	assert_fromnum_vs_sprintf(5e-324);
+}
+
 static void assert_fromnum(lua_Number n, const char *ref)
 {
 	char buf[UJ_CSTR_NUMBUF + 1]; /* extra byte for ending '\0' */
@@ -172,7 +254,10 @@ static void test_cstr_find(void **state)
 int main(void)
 {
 	const struct CMUnitTest tests[] = {cmocka_unit_test(test_cstr_fromint),
+					   cmocka_unit_test(test_cstr_fromu64),
 					   cmocka_unit_test(test_cstr_fromnum),
+					   cmocka_unit_test(
+						   test_cstr_fromnum_vs_sprintf),
 					   cmocka_unit_test(test_cstr_tonum),
 					   cmocka_unit_test(test_cstr_find)};
 	cmocka_set_message_output(CM_OUTPUT_TAP);
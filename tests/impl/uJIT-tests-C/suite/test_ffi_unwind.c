@@ -0,0 +1,100 @@
+/*
+ * This is a part of uJIT's testing suite.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#include "test_common_lua.h"
+
+/*
+ * Errors thrown from foreign code called via FFI or from FFI callbacks must
+ * unwind foreign frames with the external unwinder, so that their cleanups
+ * (C++ destructors and alike) are run.
+ */
+
+static int cleanups;
+
+static void count_cleanup(int *unused)
+{
+	(void)unused;
+	cleanups++;
+}
+
+/* Plays the role of foreign code calling back into Lua. */
+static int call_cb(int (*cb)(int), int arg)
+{
+	int guard __attribute__((cleanup(count_cleanup))) = 0;
+
+	(void)guard;
+	return cb(arg);
+}
+
+/* Plays the role of foreign code raising an error. */
+static void raise_error(lua_State *L)
+{
+	int guard __attribute__((cleanup(count_cleanup))) = 0;
+
+	(void)guard;
+	luaL_error(L, "foreign");
+}
+
+static void test_ffi_call_error(void **state)
+{
+	UNUSED_STATE(state);
+	const char chunk[] =
+		"local ffi = require('ffi')\n"
+		"local L, raise = ...\n"
+		"raise = ffi.cast('void (*)(void *)', raise)\n"
+		"for _ = 1, 100 do\n"
+		"  local ok, err = pcall(raise, L)\n"
+		"  assert(not ok and err == 'foreign')\n"
+		"end\n";
+	lua_State *L = test_lua_open();
+
+	luaL_openlibs(L);
+	cleanups = 0;
+	assert_int_equal(luaL_loadbuffer(L, chunk, sizeof(chunk) - 1, "=ffi"),
+			 0);
+	lua_pushlightuserdata(L, L);
+	lua_pushlightuserdata(L, (void *)raise_error);
+	assert_int_equal(lua_pcall(L, 2, 0, 0), 0);
+	assert_int_equal(cleanups, 100);
+	lua_close(L);
+}
+
+static void test_ffi_callback_error(void **state)
+{
+	UNUSED_STATE(state);
+	const char chunk[] =
+		"local ffi = require('ffi')\n"
+		"local call_cb = ffi.cast('int (*)(int (*)(int), int)', ...)\n"
+		"local cb = ffi.cast('int (*)(int)', function(x)\n"
+		"  if x < 0 then error('negative', 0) end\n"
+		"  return x + 1\n"
+		"end)\n"
+		"for i = 1, 100 do\n"
+		"  local ok, err = pcall(call_cb, cb, -i)\n"
+		"  assert(not ok and err == 'negative')\n"
+		"  assert(call_cb(cb, i) == i + 1)\n"
+		"end\n"
+		"cb:free()\n";
+	lua_State *L = test_lua_open();
+
+	luaL_openlibs(L);
+	cleanups = 0;
+	assert_int_equal(luaL_loadbuffer(L, chunk, sizeof(chunk) - 1, "=ffi"),
+			 0);
+	lua_pushlightuserdata(L, (void *)call_cb);
+	assert_int_equal(lua_pcall(L, 1, 0, 0), 0);
+	assert_int_equal(cleanups, 200);
+	lua_close(L);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_ffi_call_error),
+		cmocka_unit_test(test_ffi_callback_error)};
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
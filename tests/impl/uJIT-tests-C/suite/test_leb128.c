@@ -184,6 +184,16 @@ static void test_read_leb128(void **state)
 	assert_true(bytes_read == 3);
 	assert_true(value == (int64_t)-624485);
 
+	/* Sign extension of a value longer than 32 bits. */
+	buffer[0] = 0x80;
+	buffer[1] = 0x80;
+	buffer[2] = 0x80;
+	buffer[3] = 0x80;
+	buffer[4] = 0x78;
+	bytes_read = read_leb128(&value, buffer);
+	assert_true(bytes_read == 5);
+	assert_true(value == (int64_t)INT32_MIN);
+
 	memset(buffer, 0x80, 9);
 	buffer[9] = 0x7f;
 	bytes_read = read_leb128(&value, buffer);
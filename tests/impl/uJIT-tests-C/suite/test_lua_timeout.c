@@ -843,6 +843,74 @@ static void test_timeout_ignored(void **state)
 	assert_test_cleanup(L);
 }
 
+static volatile sig_atomic_t nsignals;
+
+static void count_signal(int signo)
+{
+	(void)signo;
+	nsignals++;
+}
+
+static void set_counting_handler(int signo, struct sigaction *old)
+{
+	struct sigaction sa;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = count_signal;
+	sigemptyset(&sa.sa_mask);
+	assert_int_equal(sigaction(signo, &sa, old), 0);
+}
+
+static void assert_counting_handler(int signo)
+{
+	struct sigaction cur;
+
+	assert_int_equal(sigaction(signo, NULL, &cur), 0);
+	assert_true(cur.sa_handler == count_signal);
+}
+
+/*
+ * CASE: Ensure that timeouts work with ticks counted by a dedicated thread
+ * and that no signals are delivered to the process in this mode.
+ */
+
+static void test_timeout_ticker_thread(void **state)
+{
+	struct sigaction old_prof, old_alrm;
+	lua_State *L = test_lua_open();
+	lua_State *L1;
+
+	UNUSED_STATE(state);
+
+	set_counting_handler(SIGPROF, &old_prof);
+	set_counting_handler(SIGALRM, &old_alrm);
+	nsignals = 0;
+
+	luaL_openlibs(L);
+	assert_int_equal(luaE_intinit(LUAE_INT_THREAD), LUAE_INT_SUCCESS);
+	assert_int_equal(luaE_intinit(LUAE_INT_THREAD), LUAE_INT_ERR);
+	assert_int_equal(luaL_dostring(L, chunk_forever_loop), 0);
+
+	/* No signal handlers are installed in this mode. */
+	assert_counting_handler(SIGPROF);
+	assert_counting_handler(SIGALRM);
+
+	L1 = lua_newthread(L);
+	assert_coroutine_init(L1, &default_timeout, NULL);
+	assert_coroutine_timeout(L1, 0);
+
+	/* And no signals are delivered while the timeout is counted. */
+	assert_counting_handler(SIGPROF);
+	assert_counting_handler(SIGALRM);
+	assert_int_equal(nsignals, 0);
+
+	assert_test_cleanup(L);
+	assert_int_equal(luaE_intterm(), LUAE_INT_ERR);
+
+	assert_int_equal(sigaction(SIGPROF, &old_prof, NULL), 0);
+	assert_int_equal(sigaction(SIGALRM, &old_alrm, NULL), 0);
+}
+
 /****************************** RUN ALL CASES ******************************/
 
 int main(void)
@@ -869,6 +937,7 @@ int main(void)
 		cmocka_unit_test(test_introspection_in_handler),
 		cmocka_unit_test(test_no_timed_resume_from_lua),
 		cmocka_unit_test(test_timeout_ignored),
+		cmocka_unit_test(test_timeout_ticker_thread),
 	};
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 	return cmocka_run_group_tests(tests, NULL, NULL);
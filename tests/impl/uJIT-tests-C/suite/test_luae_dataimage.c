@@ -0,0 +1,139 @@
+/*
+ * This is a part of uJIT's testing suite.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#include <stdio.h>
+
+#include "test_common_lua.h"
+
+static const char chunk_root[] =
+	"local shared = {x = 1}\n"
+	"local root = {\n"
+	"	answer = 42, pi = 3.5, flag = true,\n"
+	"	ints = {-134217728, -134217729, -1000000000, -2147483648},\n"
+	"	list = {'foo', 'bar', 'baz'},\n"
+	"	a = shared, b = shared,\n"
+	"	add = function(x, y) return x + y end,\n"
+	"}\n"
+	"root.self = root\n"
+	"return root\n";
+
+static const char chunk_check[] =
+	"local root = ...\n"
+	"assert(root.answer == 42 and root.pi == 3.5 and root.flag == true)\n"
+	"assert(#root.list == 3 and root.list[2] == 'bar')\n"
+	"assert(root.ints[1] == -134217728 and root.ints[2] == -134217729)\n"
+	"assert(root.ints[3] == -1000000000 and root.ints[4] == -2147483648)\n"
+	"assert(root.a == root.b and root.a.x == 1)\n"
+	"assert(root.self == root)\n"
+	"assert(root.add(2, 3) == 5)\n"
+	"assert(not pcall(function() root.answer = 0 end))\n";
+
+static lua_State *aux_new_datastate(void)
+{
+	lua_State *L = luaE_createstate(NULL);
+
+	assert_non_null(L);
+	luaL_openlibs(L);
+	assert_int_equal(luaL_dostring(L, chunk_root), 0);
+	luaE_setdataroot(L, -1);
+	luaE_seal(L, -1);
+	lua_pop(L, 1);
+	assert_stack_size(L, 0);
+	return L;
+}
+
+static void aux_check_dataroot(lua_State *DL)
+{
+	struct luae_Options opt = {0};
+	lua_State *L;
+
+	opt.datastate = DL;
+	L = luaE_createstate(&opt);
+	assert_non_null(L);
+	luaL_openlibs(L);
+
+	assert_int_equal(luaL_loadstring(L, chunk_check), 0);
+	luaE_getdataroot(L);
+	assert_int_equal(lua_pcall(L, 1, 0, 0), 0);
+	assert_stack_size(L, 0);
+
+	lua_close(L);
+}
+
+static void test_save_and_load(void **state)
+{
+	UNUSED_STATE(state);
+
+	lua_State *DL = aux_new_datastate();
+	lua_State *loaded;
+	FILE *fp = tmpfile();
+
+	assert_non_null(fp);
+	assert_int_equal(luaE_savedataroot(DL, fp), 0);
+	assert_stack_size(DL, 0);
+
+	loaded = luaE_loaddatastate(NULL, fp);
+	assert_non_null(loaded);
+	assert_stack_size(loaded, 0);
+	aux_check_dataroot(loaded);
+
+	lua_close(loaded);
+	lua_close(DL);
+	fclose(fp);
+}
+
+static void test_save_unsupported(void **state)
+{
+	UNUSED_STATE(state);
+
+	lua_State *L = luaE_createstate(NULL);
+	FILE *fp = tmpfile();
+
+	assert_non_null(L);
+	assert_non_null(fp);
+	luaL_openlibs(L);
+
+	/* Data root refers to a C function. */
+	assert_int_equal(luaL_dostring(L, "return {print = print}"), 0);
+	luaE_setdataroot(L, -1);
+	lua_pop(L, 1);
+
+	assert_int_not_equal(luaE_savedataroot(L, fp), 0);
+	assert_stack_size(L, 0);
+
+	lua_close(L);
+	fclose(fp);
+}
+
+static void test_load_malformed(void **state)
+{
+	UNUSED_STATE(state);
+
+	static const char garbage[] = "\033UJD\001\007garbage";
+	FILE *fp = tmpfile();
+
+	assert_non_null(fp);
+
+	/* Empty file. */
+	assert_null(luaE_loaddatastate(NULL, fp));
+
+	assert_int_equal(fwrite(garbage, 1, sizeof(garbage) - 1, fp),
+			 sizeof(garbage) - 1);
+	assert_int_equal(fflush(fp), 0);
+	assert_null(luaE_loaddatastate(NULL, fp));
+
+	fclose(fp);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_save_and_load),
+		cmocka_unit_test(test_save_unsupported),
+		cmocka_unit_test(test_load_malformed)};
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,92 @@
+/*
+ * This is a part of uJIT's testing suite.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#include "test_common_lua.h"
+
+static int aux_pcall_serialize(lua_State *L)
+{
+	assert_stack_size(L, 1);
+	luaE_serialize(L, 1);
+	return 1;
+}
+
+static int aux_pcall_deserialize(lua_State *L)
+{
+	size_t len;
+	const char *buf = lua_tolstring(L, 1, &len);
+
+	luaE_deserialize(L, buf, len);
+	return 1;
+}
+
+static void test_serialize_between_states(void **state)
+{
+	UNUSED_STATE(state);
+
+	const char chunk_value[] = "local shared = {1, 2, 3}\n"
+				   "local t = {a = shared, b = shared,\n"
+				   "           s = 'foo', n = 0.5, [42] = true}\n"
+				   "t.self = t\n"
+				   "return t\n";
+	const char chunk_check[] = "local t = ...\n"
+				   "assert(t.a == t.b and t.a[3] == 3)\n"
+				   "assert(t.s == 'foo' and t.n == 0.5)\n"
+				   "assert(t[42] == true and t.self == t)\n";
+
+	lua_State *L1 = test_lua_open();
+	lua_State *L2 = test_lua_open();
+	const char *buf;
+	size_t len;
+
+	luaL_openlibs(L2);
+	assert_int_equal(luaL_dostring(L1, chunk_value), 0);
+	luaE_serialize(L1, -1);
+	assert_stack_size(L1, 2);
+	buf = lua_tolstring(L1, -1, &len);
+	assert_non_null(buf);
+
+	assert_int_equal(luaL_loadstring(L2, chunk_check), 0);
+	luaE_deserialize(L2, buf, len);
+	assert_true(lua_istable(L2, -1));
+	assert_int_equal(lua_pcall(L2, 1, 0, 0), 0);
+	assert_stack_size(L2, 0);
+
+	lua_close(L1);
+	lua_close(L2);
+}
+
+static void test_serialize_errors(void **state)
+{
+	UNUSED_STATE(state);
+
+	lua_State *L = test_lua_open();
+
+	/* Functions are not serialized. */
+	lua_pushcfunction(L, aux_pcall_serialize);
+	assert_int_equal(luaL_dostring(L, "return {function() end}"), 0);
+	assert_int_equal(lua_pcall(L, 1, 1, 0), LUA_ERRRUN);
+	test_substring(L, -1, "attempt to serialize an object");
+	lua_pop(L, 1);
+
+	/* Malformed data. */
+	lua_pushcfunction(L, aux_pcall_deserialize);
+	lua_pushstring(L, "\006\001");
+	assert_int_equal(lua_pcall(L, 1, 1, 0), LUA_ERRRUN);
+	test_substring(L, -1, "malformed serialized data");
+	lua_pop(L, 1);
+
+	assert_stack_size(L, 0);
+	lua_close(L);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_serialize_between_states),
+		cmocka_unit_test(test_serialize_errors)};
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,92 @@
+/*
+ * This is a part of uJIT's testing suite.
+ * Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+ * Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "test_common_lua.h"
+
+#define JITDUMP_MAGIC "DTiJ"
+
+static lua_State *perfjit_open(const char *name)
+{
+	const char chunk[] = "jit.opt.start(0, 'hotloop=1')\n"
+			     "assert(ujit.dump.perfstart('jitdump'))\n";
+	lua_State *L = test_lua_open();
+
+	luaL_openlibs(L);
+	assert_int_equal(luaL_loadbuffer(L, chunk, sizeof(chunk) - 1, name), 0);
+	assert_int_equal(lua_pcall(L, 0, 0, 0), 0);
+	return L;
+}
+
+static void perfjit_compile(lua_State *L, const char *name)
+{
+	const char chunk[] = "for _ = 1, 100 do end\n";
+
+	assert_int_equal(luaL_loadbuffer(L, chunk, sizeof(chunk) - 1, name), 0);
+	assert_int_equal(lua_pcall(L, 0, 0, 0), 0);
+}
+
+static size_t count_occurrences(const char *buf, size_t size, const char *s)
+{
+	size_t len = strlen(s);
+	size_t count = 0;
+	size_t i;
+
+	for (i = 0; i + len <= size; i++)
+		if (memcmp(buf + i, s, len) == 0)
+			count++;
+	return count;
+}
+
+/* States of the same process emit to the same jitdump file. */
+static void test_jitdump_shared(void **state)
+{
+	UNUSED_STATE(state);
+
+	char fname[64];
+	char *buf;
+	long size;
+	FILE *fp;
+	lua_State *L1 = perfjit_open("=first");
+	lua_State *L2;
+
+	perfjit_compile(L1, "=first");
+	L2 = perfjit_open("=second");
+	perfjit_compile(L2, "=second");
+	lua_close(L1);
+	perfjit_compile(L2, "=second");
+	lua_close(L2);
+
+	sprintf(fname, "/tmp/jit-%d.dump", (int)getpid());
+	fp = fopen(fname, "rb");
+	assert_non_null(fp);
+	assert_int_equal(fseek(fp, 0, SEEK_END), 0);
+	size = ftell(fp);
+	assert_true(size > 0);
+	rewind(fp);
+	buf = malloc((size_t)size);
+	assert_non_null(buf);
+	assert_int_equal(fread(buf, 1, (size_t)size, fp), (size_t)size);
+	fclose(fp);
+	remove(fname);
+
+	assert_int_equal(memcmp(buf, JITDUMP_MAGIC, 4), 0);
+	assert_int_equal(count_occurrences(buf, (size_t)size, JITDUMP_MAGIC), 1);
+	assert_int_equal(count_occurrences(buf, (size_t)size, " =first:1"), 1);
+	assert_int_equal(count_occurrences(buf, (size_t)size, " =second:1"), 2);
+	free(buf);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_jitdump_shared)};
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
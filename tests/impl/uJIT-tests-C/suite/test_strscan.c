@@ -163,6 +163,18 @@ static void test_decimal(void **state)
 	assert_true(conv.d == -2.203e-41);
 	assert_true(conv.u == 0xB77EB49111205B88);
 
+	/* Short mantissa and exponent, see strscan_fastdec */
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("0.1", 0.1);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("-.25", -0.25);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("0.000123", 0.000123);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("1.50", 1.5);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("123456789.012345", 123456789.012345);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("1234567890.123456", 1234567890.123456);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("9.87654321e22", 9.87654321e22);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("9.87654321e-22", 9.87654321e-22);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("1e23", 1e23);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("1e-23", 1e-23);
+
 	/* Exponential notation, floating point: subnormal */
 	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("0.4E-323", 0.4E-323);
 	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("-0.4E-323", -0.4E-323);
@@ -217,6 +229,18 @@ static void test_hexadecimal(void **state)
 	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("-0x22.03p23", -0x2.203p27);
 	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("-0x22.03p-23", -0x2.203p-19);
 
+	/* Short mantissa and exponent, see strscan_fastdec */
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("0.1", 0.1);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("-.25", -0.25);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("0.000123", 0.000123);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("1.50", 1.5);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("123456789.012345", 123456789.012345);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("1234567890.123456", 1234567890.123456);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("9.87654321e22", 9.87654321e22);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("9.87654321e-22", 9.87654321e-22);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("1e23", 1e23);
+	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("1e-23", 1e-23);
+
 	/* Exponential notation, floating point: subnormal */
 
 	ASSERT_STRSCAN_GOOD_CONV_TO_NUM("+0xFF.Fp-1079", 0xFF.Fp-1079);
@@ -18,16 +18,28 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/bc_hotcnt/loop_repeat.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/bc_hotcnt/loop_while.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/bit
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/bit/shift-var-pressure.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/bit/shift-var.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/bit/tohex.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/cli-X
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/cli-X/any.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/cli-X/bcopt-thread.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/cli-X/bcopt.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/cli-X/superins.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-abs-neg
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-abs-neg/abs-neg.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-concat
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-concat/concat.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-concat/no-tbar-cse.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-ffi
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-ffi/alloc.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-ffi/index.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-ffi/ptrdiff.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-getfenv
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-getfenv/getfenv.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-phi
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-phi/rotate.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-phi/swap.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-sink
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-sink/nosink.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/compiler-sink/partsinkouter.lua
@@ -48,10 +60,15 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-compiler/bindings.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-compiler/bitwise.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-compiler/calls.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-compiler/exits.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-compiler/memrefs.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-compiler/progress.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-compiler/strings.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-compiler/upvalues.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-heap
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-heap/heap.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-perf
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-perf/perf.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-stack
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dump-stack/frames.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dumpbc
@@ -68,6 +85,7 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/dumpbc/try-overflow-hint-buffer.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/errors
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/errors/errors.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/errors/unwind.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/immutable
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/immutable/immutable-global.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/immutable/immutable-jit-metatable.lua
@@ -101,9 +119,13 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/ir_indexed/store/nonnil_nomt.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/ir_indexed/store/table_newindex.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/jit-options
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/jit-options/fuse.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/jit-options/jitcat.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/jit-options/nohrefk.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/jit-options/noretl.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/jit-options/retrace-inner.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/jit-options/retrace-limit.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/jit-options/retrace.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/leb128
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/leb128/bc-dump-reference.out
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/leb128/bc-dump.lua
@@ -128,11 +150,17 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/memprof
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/memprof/duration.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/memprof/memprof.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/memprof/sample.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/meta-comp
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/meta-comp/meta-comp-lt.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/meta-index-cache
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/meta-index-cache/invalidate.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-gc
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-gc/allocated-freed.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-gc/gcsteps.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-jit-compile
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-jit-compile/abort.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-jit-compile/loop.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-snap-restores
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-snap-restores/loop-direct.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/metrics-snap-restores/loop-side-exit-non-compiled.lua
@@ -201,6 +229,8 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/seal/seal-without-metatable-jit-tsetv.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/seal/seal.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/buffer-recording.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/buffer.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/bufhdr-append.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/bufput-fuse.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/bufput-const-fold.lua
@@ -213,6 +243,9 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/find-upper-lower-recording.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/find.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/format.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/helpers.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/jit-helpers.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/jit-split.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/jit-trim.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/split.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/string/trim.lua
@@ -223,10 +256,16 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/concat/concat_throw_on_recording1.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/concat/concat_throw_on_recording2.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/data.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/encode
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/encode/encode.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/debug.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/mm
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/mm/nargs.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/naive.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/newclear
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/newclear/newclear.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/newclear/newref.lua
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/newclear/recording.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/recording
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/recording.lua
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/chunks/table/recording/asize_shallowcopy.lua
@@ -254,9 +293,13 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/cli-X.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/compiler-abs-neg.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/compiler-concat.t
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/compiler-ffi.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/compiler-getfenv.t
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/compiler-phi.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/coverage.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/dump-compiler.t
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/dump-heap.t
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/dump-perf.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/dump-stack.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/dumpbc.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/errors.t
@@ -271,7 +314,9 @@ list(APPEND SUITE_SOURCES
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/math.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/memprof.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/meta-comp.t
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/meta-index-cache.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/metrics-gc.t
+  ${CMAKE_CURRENT_SOURCE_DIR}/suite/metrics-jit-compile.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/metrics-snap-restores.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/metrics-strhash.t
   ${CMAKE_CURRENT_SOURCE_DIR}/suite/movtv.t
@@ -16,3 +16,8 @@ my $tester = UJit::Test->new(
 );
 
 $tester->run('tohex.lua')->exit_ok;
+$tester->run('shift-var.lua')->exit_ok;
+$tester->run('shift-var-pressure.lua')
+    ->exit_ok
+    ->stdout_has('---- TOTAL 0')
+;
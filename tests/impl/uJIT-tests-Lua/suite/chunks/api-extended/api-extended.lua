@@ -24,11 +24,16 @@ assert(table_size(ujit.debug) == 1)
 assert(type(ujit.debug.gettableinfo) == "function")
 
 -- ujit.dump
-assert(table_size(ujit.dump) == 7)
+assert(table_size(ujit.dump) == 12)
 
+assert(type(ujit.dump.aborts) == "function")
 assert(type(ujit.dump.bc) == "function")
 assert(type(ujit.dump.bcins) == "function")
+assert(type(ujit.dump.exits) == "function")
+assert(type(ujit.dump.heap) == "function")
 assert(type(ujit.dump.mcode) == "function")
+assert(type(ujit.dump.perfstart) == "function")
+assert(type(ujit.dump.perfstop) == "function")
 assert(type(ujit.dump.stack) == "function")
 assert(type(ujit.dump.start) == "function")
 assert(type(ujit.dump.stop) == "function")
@@ -54,8 +59,10 @@ assert(type(ujit.math.ispinf) == "function")
 assert(type(ujit.math.nan) == "number")
 
 -- ujit.memprof
-assert(table_size(ujit.memprof) == 2)
+assert(table_size(ujit.memprof) == 4)
 
+assert(type(ujit.memprof.report) == "function")
+assert(type(ujit.memprof.sample) == "function")
 assert(type(ujit.memprof.start) == "function")
 assert(type(ujit.memprof.stop) == "function")
 
@@ -69,15 +76,23 @@ assert(type(ujit.profile.stop) == "function")
 assert(type(ujit.profile.terminate) == "function")
 
 -- ujit.string
-assert(table_size(ujit.string) == 2)
+assert(table_size(ujit.string) == 6)
 
+assert(type(ujit.string.buffer) == "function")
+assert(type(ujit.string.count) == "function")
+assert(type(ujit.string.endswith) == "function")
 assert(type(ujit.string.split) == "function")
+assert(type(ujit.string.startswith) == "function")
 assert(type(ujit.string.trim) == "function")
 
 -- ujit.table
-assert(table_size(ujit.table) == 6)
+assert(table_size(ujit.table) == 10)
 
+assert(type(ujit.table.clear) == "function")
+assert(type(ujit.table.decode) == "function")
+assert(type(ujit.table.encode) == "function")
 assert(type(ujit.table.keys) == "function")
+assert(type(ujit.table.new) == "function")
 assert(type(ujit.table.rindex) == "function")
 assert(type(ujit.table.shallowcopy) == "function")
 assert(type(ujit.table.size) == "function")
@@ -38,6 +38,10 @@ assert_call(1, "userdata", "nil", ujit.dump.bc, nil)
 assert_call(2, "function", "no value", ujit.dump.bc, io.stdout)
 assert_call(2, "function", "nil", ujit.dump.bc, io.stdout, nil)
 
+-- ujit.dump.heap(io_obj)
+assert_call(1, "userdata", "no value", ujit.dump.heap)
+assert_call(1, "userdata", "nil", ujit.dump.heap, nil)
+
 -- ujit.dump.bcins(io_obj, func, pc[, nest_lvl])
 local dumped = ujit.dump.bcins(io.stdout, assert_call, 1)
 assert(dumped == true)
@@ -66,6 +70,18 @@ ujit.dump.mcode(io.stdout, 1, ETAB, ESTR)
 assert_call(1, "userdata", "nil", ujit.dump.mcode, nil, 1)
 assert_call(2, "number", "no value", ujit.dump.mcode, io.stdout)
 assert_call(2, "number", "nil", ujit.dump.mcode, io.stdout, nil)
+
+-- ujit.dump.exits(io_obj, traceno)
+ujit.dump.exits(io.stdout, 1)
+ujit.dump.exits(io.stdout, 1, ETAB, ESTR)
+assert_call(1, "userdata", "nil", ujit.dump.exits, nil, 1)
+assert_call(2, "number", "no value", ujit.dump.exits, io.stdout)
+assert_call(2, "number", "nil", ujit.dump.exits, io.stdout, nil)
+
+-- ujit.dump.aborts(io_obj)
+ujit.dump.aborts(io.stdout)
+ujit.dump.aborts(io.stdout, ETAB, ESTR)
+assert_call(1, "userdata", "nil", ujit.dump.aborts, nil)
 jit.off()
 
 -- ujit.dump.stack(io_obj)
@@ -84,6 +100,16 @@ ujit.dump.stop(ETAB, ESTR)
 os.remove(fname_dump)
 assert(stopped == true)
 
+-- ujit.dump.perfstart([format])
+local _, fname_perf = ujit.dump.perfstart("map", ETAB, ENIL)
+ujit.dump.perfstart()
+assert_call(1, "string", "table", ujit.dump.perfstart, ETAB)
+
+stopped = ujit.dump.perfstop()
+ujit.dump.perfstop(ETAB, ESTR)
+os.remove(fname_perf)
+assert(stopped == true)
+
 -- ujit.dump.trace(io_obj, traceno)
 ujit.dump.trace(io.stdout, 1, ETAB, ENIL)
 assert_call(1, "userdata", "no value", ujit.dump.trace)
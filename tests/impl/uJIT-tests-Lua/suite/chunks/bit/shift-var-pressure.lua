@@ -0,0 +1,41 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+--
+-- Tests to check shifts by a variable count in compiled code against the
+-- interpreter when all general purpose registers are occupied, so that
+-- operands of shifts have to be spilled.
+--
+
+jit.opt.start(3, "hotloop=1")
+
+local lshift, rshift, arshift = bit.lshift, bit.rshift, bit.arshift
+local bxor, band = bit.bxor, bit.band
+
+local function shifts(n)
+  local res = {}
+  for i = 1, n do
+    local v1, v2, v3, v4 = band(i * 3, 31), band(i * 5, 31), band(i * 7, 31), band(i * 11, 31)
+    local v5, v6, v7, v8 = band(i * 13, 31), band(i * 17, 31), band(i * 19, 31), band(i * 23, 31)
+    local w1, w2, w3, w4 = i * 7919, -i * 104729, i * 1299709, -i * 15485863
+    local w5, w6, w7, w8 = i * 86028121, -i * 179424673, i * 49979687, -i * 32452843
+    local x1, x2, x3, x4 = lshift(w1, v8), rshift(w2, v7), arshift(w3, v6), lshift(w4, v5)
+    local x5, x6, x7, x8 = rshift(w5, v4), arshift(w6, v3), lshift(w7, v2), rshift(w8, v1)
+    local y1, y2, y3, y4 = arshift(x1, v1), lshift(x2, v2), rshift(x3, v3), arshift(x4, v4)
+    local y5, y6, y7, y8 = lshift(x5, v5), rshift(x6, v6), arshift(x7, v7), lshift(x8, v8)
+    res[i] = bxor(v1, v2, v3, v4, v5, v6, v7, v8, w1, w2, w3, w4, w5, w6, w7, w8,
+                  x1, x2, x3, x4, x5, x6, x7, x8, y1, y2, y3, y4, y5, y6, y7, y8)
+  end
+  return res
+end
+
+local compiled = shifts(100)
+jit.off(shifts)
+local interpreted = shifts(100)
+
+for i = 1, 100 do
+  assert(compiled[i] == interpreted[i])
+end
+
+ujit.dump.aborts(io.stdout)
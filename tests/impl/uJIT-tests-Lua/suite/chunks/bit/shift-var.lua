@@ -0,0 +1,34 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+--
+-- Tests to check shifts by a variable count in compiled code (BMI2 shifts
+-- are used when available) against the interpreter.
+--
+
+jit.opt.start(3, "hotloop=1")
+
+local lshift, rshift, arshift, rol = bit.lshift, bit.rshift, bit.arshift, bit.rol
+local bxor = bit.bxor
+
+local function shifts(n)
+  local res = {}
+  for i = 1, n do
+    local a, b = i * 7919, -i * 104729
+    local c1, c2 = i % 37, (i * 13) % 29 -- Counts above 31 are masked.
+    local x = lshift(a, c1)
+    local y = rshift(b, c2)
+    local z = arshift(b, c1)
+    res[i] = bxor(x, y, z, lshift(x, c2), arshift(y, c1), rol(z, c2))
+  end
+  return res
+end
+
+local compiled = shifts(100)
+jit.off(shifts)
+local interpreted = shifts(100)
+
+for i = 1, 100 do
+  assert(compiled[i] == interpreted[i])
+end
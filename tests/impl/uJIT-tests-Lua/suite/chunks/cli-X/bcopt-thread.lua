@@ -0,0 +1,23 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Materializing the result of the comparison ends with a JMP over the
+-- "false" load, which lands on the JMP leaving the "then" branch. The
+-- former can be threaded to the destination of the latter.
+local function classify(x, y)
+  local r
+  if x then
+    r = y == 1
+  elseif y then
+    r = 0
+  end
+  return tostring(r)
+end
+
+for _ = 1, 100 do
+  assert(classify(true, 1) == "true")
+  assert(classify(true, 2) == "false")
+  assert(classify(false, 2) == "0")
+  assert(classify(false, false) == "nil")
+end
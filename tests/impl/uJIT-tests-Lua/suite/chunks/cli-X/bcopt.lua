@@ -0,0 +1,20 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- The jump from the end of the "then" branch lands on RET1
+-- and can be replaced with a copy of it.
+local function choose(x)
+  local y
+  if x then
+    y = 1
+  else
+    y = 2
+  end
+  return y
+end
+
+for _ = 1, 100 do
+  assert(choose(true) == 1)
+  assert(choose(false) == 2)
+end
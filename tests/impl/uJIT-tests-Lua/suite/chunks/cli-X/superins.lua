@@ -0,0 +1,10 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Loads of a field chain are fused into TGETSS + TGETS.
+local t = {a = {b = {c = 42}}}
+
+for _ = 1, 100 do
+  assert(t.a.b.c == 42)
+end
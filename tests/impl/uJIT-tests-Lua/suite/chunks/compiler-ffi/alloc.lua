@@ -0,0 +1,51 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Allocations initialized with aggregates, allocations of large objects and
+-- unions.
+
+local ffi = require('ffi')
+
+jit.opt.start(3, "hotloop=1")
+
+ffi.cdef([[
+  typedef struct { int32_t x, y; } pt_t;
+  typedef struct { pt_t a, b; int32_t tag; } seg_t;
+  typedef struct { double v[40]; } big_t;
+  typedef union { int32_t i; float f; } num_t;
+]])
+
+local pt_t, seg_t = ffi.typeof('pt_t'), ffi.typeof('seg_t')
+local big_t, num_t = ffi.typeof('big_t'), ffi.typeof('num_t')
+
+local function alloc(n)
+  local p = pt_t(3, 4)
+  local s = 0
+  for i = 1, n do
+    -- Struct fields copied from cdata and cleared.
+    local seg = seg_t(p, p, i)
+    s = s + seg.a.x + seg.b.y + seg.tag
+    local part = seg_t(p)
+    s = s + part.a.y + part.b.x + part.b.y + part.tag
+    -- Array of structs, the single initializer is replicated.
+    local pts = ffi.new('pt_t[3]', p)
+    s = s + pts[0].x + pts[2].y
+    -- Large object cleared in one go.
+    local big = big_t()
+    big.v[39] = i
+    s = s + big.v[0] + big.v[39]
+    -- Large object copied.
+    local copy = big_t(big)
+    s = s + copy.v[39]
+    -- Only the first member of a union is initialized.
+    s = s + num_t(i).i
+  end
+  return s
+end
+
+local compiled = alloc(100)
+jit.off(alloc)
+assert(compiled == alloc(100))
+
+ujit.dump.aborts(io.stdout)
@@ -0,0 +1,29 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- __index table of a metatype looked up with non-string keys.
+
+local ffi = require('ffi')
+
+jit.opt.start(3, "hotloop=1")
+
+local obj_t = ffi.metatype('struct { int32_t id; }', {
+  __index = { [1] = 10, [2.5] = 20, [true] = 30, name = 40 },
+})
+
+local function lookup(n)
+  local obj = obj_t(1)
+  local s = 0
+  for _ = 1, n do
+    s = s + obj[1] + obj[2.5] + obj[true] + obj.name
+  end
+  return s
+end
+
+local compiled = lookup(100)
+jit.off(lookup)
+assert(compiled == lookup(100))
+assert(compiled == 10000)
+
+ujit.dump.aborts(io.stdout)
@@ -0,0 +1,25 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Pointer difference for element sizes which are not powers of two.
+
+local ffi = require('ffi')
+
+jit.opt.start(3, "hotloop=1")
+
+local function diff(arr, n)
+  local s = 0
+  for i = 1, n do
+    s = s + ((arr + (i % 100)) - (arr + 50))
+  end
+  return s
+end
+
+local arr = ffi.new('struct { uint8_t raw[3]; }[100]')
+local compiled = diff(arr, 1000)
+jit.off(diff)
+assert(compiled == diff(arr, 1000))
+assert(compiled == -500)
+
+ujit.dump.aborts(io.stdout)
@@ -0,0 +1,27 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Rotation of more loop-carried numbers than there are registers: the
+-- right operand of each PHI is the left operand of another one.
+
+jit.opt.start(3, "hotloop=1")
+
+local function rotate(n)
+  local v1, v2, v3, v4, v5, v6, v7, v8, v9, v10 = 1, 2, 3, 4, 5, 6, 7, 8, 9, 10
+  local v11, v12, v13, v14, v15, v16, v17, v18, v19, v20 =
+    11, 12, 13, 14, 15, 16, 17, 18, 19, 20
+  for i = 1, n do
+    v1, v2, v3, v4, v5, v6, v7, v8, v9, v10,
+    v11, v12, v13, v14, v15, v16, v17, v18, v19, v20 =
+      v2, v3, v4, v5, v6, v7, v8, v9, v10, v11,
+      v12, v13, v14, v15, v16, v17, v18, v19, v20, v1 + i
+  end
+  return v1 + v2 * 2 + v3 * 3 + v5 * 5 + v8 * 8 + v13 * 13 + v20 * 20
+end
+
+local compiled = rotate(100)
+jit.off(rotate)
+assert(compiled == rotate(100))
+
+ujit.dump.aborts(io.stdout)
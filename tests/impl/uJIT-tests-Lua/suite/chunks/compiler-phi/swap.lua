@@ -0,0 +1,26 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Pairwise swaps of more loop-carried numbers than there are registers:
+-- spilled PHIs form cycles which must be broken.
+
+jit.opt.start(3, "hotloop=1")
+
+local function swap(n)
+  local a1, a2, a3, a4, a5, a6, a7, a8, a9, a10 = 1, 2, 3, 4, 5, 6, 7, 8, 9, 10
+  local b1, b2, b3, b4, b5, b6, b7, b8, b9, b10 =
+    11, 12, 13, 14, 15, 16, 17, 18, 19, 20
+  for i = 1, n do
+    a1, b1, a2, b2, a3, b3, a4, b4, a5, b5 = b1, a1, b2, a2, b3, a3, b4, a4, b5, a5
+    a6, b6, a7, b7, a8, b8, a9, b9, a10, b10 =
+      b6, a6, b7, a7, b8, a8, b9, a9, b10 + i, a10
+  end
+  return a1 - b1 + (a2 - b2) * 2 + (a6 - b6) * 6 + (a10 - b10) * 10
+end
+
+local compiled = swap(101)
+jit.off(swap)
+assert(compiled == swap(101))
+
+ujit.dump.aborts(io.stdout)
@@ -14,19 +14,27 @@ assert(foo(10000) == 50105000)
 
 ujit.dump.trace(io.stdout, 1)
 ujit.dump.mcode(io.stdout, 1)
+ujit.dump.exits(io.stdout, 1)
+ujit.dump.aborts(io.stdout)
 
 -- Non-existent trace number:
 ujit.dump.trace(io.stdout, 1E6)
 ujit.dump.mcode(io.stdout, 1E6)
+ujit.dump.exits(io.stdout, 1E6)
 
 -- Zero arguments:
 assert(not pcall(ujit.dump.trace))
 assert(not pcall(ujit.dump.mcode))
+assert(not pcall(ujit.dump.exits))
+assert(not pcall(ujit.dump.aborts))
 
 -- One argument:
 assert(not pcall(ujit.dump.trace, io.stderr))
 assert(not pcall(ujit.dump.mcode, io.stderr))
+assert(not pcall(ujit.dump.exits, io.stderr))
 
 -- Malformed first argument (not IO):
 assert(not pcall(ujit.dump.trace, debug, 1))
 assert(not pcall(ujit.dump.mcode, debug, 1))
+assert(not pcall(ujit.dump.exits, debug, 1))
+assert(not pcall(ujit.dump.aborts, debug))
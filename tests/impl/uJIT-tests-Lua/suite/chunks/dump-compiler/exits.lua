@@ -0,0 +1,16 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Side traces are never compiled, so all exits are taken to the interpreter.
+jit.opt.start(0, "hotloop=1", "hotexit=100")
+
+local n = 0
+for i = 1, 60 do
+    if i % 3 == 0 then
+        n = n + 1
+    end
+end
+
+assert(n == 20)
+ujit.dump.exits(io.stdout, 1)
@@ -0,0 +1,19 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Dumps a heap snapshot to stdout, keeping a few distinguishable objects alive.
+
+local marker = "HEAPDUMP_MARKER_" .. string.rep("z", 100)
+
+retainer = {marker}
+local weak = setmetatable({}, {__mode = "k"})
+weak[{}] = true
+
+local co = coroutine.create(function(x)
+	coroutine.yield(x)
+end)
+coroutine.resume(co, retainer)
+
+ujit.dump.heap(io.stdout)
+io.stdout:flush()
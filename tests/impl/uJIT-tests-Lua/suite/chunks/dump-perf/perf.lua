@@ -0,0 +1,33 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Emits information about traces for perf in the format passed as the first
+-- argument and prints the emitted file to stdout.
+
+jit.opt.start(0, "hotloop=1")
+
+local format = arg[1]
+
+local function sum(n)
+  local s = 0
+  for i = 1, n do s = s + i end -- TRACE_1
+  return s
+end
+
+sum(100) -- Compiled before the start
+
+local started, fname = ujit.dump.perfstart(format)
+assert(started == true)
+assert(fname:match("^/tmp/"))
+assert(ujit.dump.perfstart(format) == false) -- Already started
+
+for _ = 1, 100 do end -- TRACE_2
+
+assert(ujit.dump.perfstop() == true)
+assert(ujit.dump.perfstop() == false) -- Already stopped
+
+local f = assert(io.open(fname, "rb"))
+io.write(f:read("*a"))
+f:close()
+os.remove(fname)
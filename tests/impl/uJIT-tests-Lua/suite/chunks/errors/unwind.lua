@@ -0,0 +1,71 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Errors caught both with and without crossing C frames of the VM.
+
+local N = 1000
+
+for i = 1, N do
+  local ok, err = pcall(error, i, 0)
+  assert(not ok and err == i)
+
+  ok, err = xpcall(function() error({i}) end, function(e) return e[1] + 1 end)
+  assert(not ok and err == i + 1)
+
+  ok, err = pcall(function() local x; return x.y end)
+  assert(not ok and err:match("attempt to index"))
+
+  -- Crossing a C frame: string.gsub calls the replacement via lua_call.
+  ok, err = pcall(string.gsub, "x", "x", function() error("gsub", 0) end)
+  assert(not ok and err == "gsub")
+
+  ok, err = pcall(coroutine.wrap(function() error("co", 0) end))
+  assert(not ok and err == "co")
+end
+
+-- Upvalues are closed and the stack is restored after unwinding.
+for i = 1, N do
+  local f
+  local ok, err = pcall(function()
+    local up = i
+    f = function() return up end
+    assert(not pcall(error, "inner"))
+    error("outer", 0)
+  end)
+  assert(not ok and err == "outer" and f() == i)
+end
+
+-- Errors in metamethods called from the VM.
+local mt = {__index = function(_, k) error("no " .. k, 0) end}
+for _ = 1, N do
+  local ok, err = pcall(function() return setmetatable({}, mt).foo end)
+  assert(not ok and err == "no foo")
+end
+
+-- Errors raised from compiled code.
+local function alloc(n)
+  for i = 1, 1000 do
+    ujit.table.new(0, i == 900 and n or 1)
+  end
+end
+for _ = 1, 100 do
+  local ok, err = pcall(alloc, 2^30)
+  assert(not ok and err:match("table overflow"))
+end
+
+-- Errors crossing foreign frames: FFI callback called by qsort.
+local ffi = require("ffi")
+ffi.cdef[[
+void qsort(void *base, size_t nmemb, size_t size,
+           int (*compar)(const void *, const void *));
+]]
+local arr = ffi.new("int[4]", 4, 3, 2, 1)
+local cmp = ffi.cast("int (*)(const void *, const void *)", function()
+  error("cmp", 0)
+end)
+for _ = 1, N do
+  local ok, err = pcall(ffi.C.qsort, arr, 4, ffi.sizeof("int"), cmp)
+  assert(not ok and err == "cmp")
+end
+cmp:free()
@@ -0,0 +1,77 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Callback arguments of all supported kinds, both in registers and on stack.
+
+local ffi = require('ffi')
+
+ffi.cdef([[
+	enum cb_color { CB_RED = 1, CB_GREEN = 2 };
+	void qsort(void *base, size_t nmemb, size_t size,
+		   int (*compar)(const int32_t *, const int32_t *));
+]])
+
+local function check_args(...)
+	local a = {...}
+	assert(a[1] == -5)
+	assert(a[2] == 65535)
+	assert(a[3] == 4294967295)
+	assert(a[4] == -2147483648)
+	assert(a[5] == true)
+	assert(a[6] == 0.5)
+	assert(a[7] == 1.25)
+	assert(a[8] == -1LL)
+	assert(a[9] == 18446744073709551615ULL)
+	assert(ffi.istype('enum cb_color', a[10]) and a[10] == 2)
+	assert(ffi.istype('void *', a[11]) and a[11] == ffi.cast('void *', 42))
+	-- Arguments passed on stack.
+	assert(a[12] == -7)
+	assert(a[13] == 9.5)
+	assert(a[14] == false)
+	assert(a[15] == 200)
+	assert(a[16] == 3)
+	return #a
+end
+
+local cb = ffi.cast('int (*)(int8_t, uint16_t, uint32_t, int32_t, bool,'
+	.. 'float, double, int64_t, uint64_t, enum cb_color, void *,'
+	.. 'int16_t, double, bool, uint8_t, int)', check_args)
+
+for _ = 1, 200 do
+	assert(cb(-5, 65535, 4294967295, -2147483648, true, 0.5, 1.25, -1LL,
+		  18446744073709551615ULL, 'CB_GREEN', ffi.cast('void *', 42),
+		  -7, 9.5, false, 200, 3) == 16)
+end
+cb:free()
+
+-- Many floating-point arguments spill to stack.
+local fcb = ffi.cast('double (*)(double, double, double, double, double,'
+	.. 'double, double, double, float, double)',
+	function(a, b, c, d, e, f, g, h, i, j)
+		return a + b + c + d + e + f + g + h + i + j
+	end)
+assert(fcb(1, 2, 3, 4, 5, 6, 7, 8, 9.5, 10) == 55.5)
+fcb:free()
+
+-- A freed slot reused with another signature gets its own conversions.
+local icb = ffi.cast('int (*)(int, int)', function(a, b) return a - b end)
+assert(icb(10, 3) == 7)
+icb:free()
+local dcb = ffi.cast('double (*)(double, int)', function(a, b) return a * b end)
+assert(dcb(1.5, 3) == 4.5)
+dcb:free()
+
+-- Hot callback called from C.
+local arr = ffi.new('int32_t[?]', 1000)
+for i = 0, 999 do
+	arr[i] = (i * 7919) % 1000
+end
+ffi.C.qsort(arr, 1000, 4, function(pa, pb)
+	return pa[0] - pb[0]
+end)
+for i = 0, 998 do
+	assert(arr[i] <= arr[i + 1])
+end
+
+os.exit(0)
@@ -0,0 +1,44 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Loading of C types with sib or cid chains looping back is rejected.
+
+local ffi = require('ffi')
+
+local CT_STRUCT, CT_PTR, CT_TYPEDEF = 0x10000000, 0x20000000, 0x70000000
+
+local function uleb128(v)
+	local s = ''
+	while v >= 0x80 do
+		s = s .. string.char(v % 0x80 + 0x80)
+		v = math.floor(v / 0x80)
+	end
+	return s .. string.char(v)
+end
+
+-- Nothing is declared, so the prologue holds the number of predefined types.
+local prologue = ffi.savetypes()
+local base = prologue:byte(-1)
+assert(base < 0x80)
+
+-- Two elements, each given as {info, sib}.
+local function types(e1, e2)
+	local s = prologue:sub(1, -2) .. uleb128(base + 2)
+	for _, e in ipairs({e1, e2}) do
+		s = s .. uleb128(e[1]) .. uleb128(0) .. uleb128(e[2]) .. uleb128(0)
+	end
+	return s
+end
+
+local n1, n2 = base, base + 1
+
+assert(not pcall(ffi.loadtypes, types({CT_STRUCT, n2}, {CT_STRUCT, n1})))
+assert(not pcall(ffi.loadtypes, types({CT_STRUCT, n1}, {CT_STRUCT, 0})))
+assert(not pcall(ffi.loadtypes, types({CT_PTR + n2, 0}, {CT_PTR + n1, 0})))
+assert(not pcall(ffi.loadtypes, types({CT_TYPEDEF + n1, 0}, {CT_STRUCT, 0})))
+
+-- Terminating chains are fine, e.g. a pointer to a struct.
+ffi.loadtypes(types({CT_PTR + n2, 0}, {CT_STRUCT, 0}))
+
+os.exit(0)
@@ -0,0 +1,70 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Usage: savetypes.lua save|load <file>
+-- In the save mode, C types are declared and saved to the file, in the load
+-- mode, they are loaded from the file to a fresh state and checked.
+
+local ffi = require('ffi')
+
+local mode, fname = arg[1], arg[2]
+assert(mode == 'save' or mode == 'load')
+assert(fname)
+
+if mode == 'save' then
+	-- Nothing is declared yet, still a valid prologue.
+	assert(type(ffi.savetypes()) == 'string')
+
+	ffi.cdef([[
+		typedef struct { int a; int b; char c[7]; } foo_t;
+		enum color { RED, GREEN = 5 };
+		struct bar { struct bar *next; foo_t f; int x:3; };
+		int abs(int);
+		static const int K = 42;
+	]])
+
+	local fh = assert(io.open(fname, 'wb'))
+	fh:write(ffi.savetypes())
+	fh:close()
+	os.exit(0)
+end
+
+local fh = assert(io.open(fname, 'rb'))
+local types = fh:read('*a')
+fh:close()
+
+-- Malformed data is rejected and nothing is declared.
+assert(not pcall(ffi.loadtypes, 'junk'))
+for i = 1, #types - 1 do
+	assert(not pcall(ffi.loadtypes, types:sub(1, i)))
+end
+assert(not pcall(ffi.typeof, 'foo_t'))
+
+ffi.loadtypes(types)
+
+assert(ffi.sizeof('foo_t') == 16)
+assert(ffi.offsetof('foo_t', 'c') == 8)
+assert(ffi.C.abs(-3) == 3)
+assert(ffi.C.K == 42)
+assert(ffi.new('enum color', 'GREEN') == 5)
+
+local bar = ffi.new('struct bar')
+bar.x = 3
+bar.f.b = 15
+bar.next = bar
+assert(bar.next.x == 3)
+assert(bar.next.f.b == 15)
+assert(ffi.typeof('struct bar *') == ffi.typeof(bar.next))
+
+-- Loaded types behave as if they were declared.
+assert(not pcall(ffi.cdef, 'struct bar { int y; };'))
+ffi.cdef('typedef struct { foo_t q; } baz_t;')
+assert(ffi.sizeof('baz_t') == 16)
+
+-- Types can be loaded only into a state without declarations.
+local ok, err = pcall(ffi.loadtypes, types)
+assert(not ok)
+assert(err:match('cannot load C types'))
+
+os.exit(0)
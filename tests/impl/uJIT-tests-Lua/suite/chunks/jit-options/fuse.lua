@@ -0,0 +1,26 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local jit_on = jit.status()
+assert(jit_on, "JIT must be on for this test")
+
+local ffi = require("ffi")
+
+jit.opt.start("hotloop=3")
+
+local N = 100
+local a = ffi.new("double[?]", N)
+local b = ffi.new("double[?]", N)
+
+for i = 0, N - 1 do
+    a[i] = i
+    b[i] = 2 * i
+end
+
+local s = 0
+for i = 0, N - 1 do
+    s = s + a[i] * b[i]
+end
+
+assert(s == 656700)
@@ -0,0 +1,25 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local jit_on = jit.status()
+assert(jit_on, "JIT must be on for this test")
+
+jit.opt.start("hotloop=3", "hotexit=3")
+
+-- The exit from the inner loop becomes hot, but re-recording the inner loop
+-- would follow the same path. A side trace is compiled instead.
+
+local S = 0
+
+local function inner(n)
+    for j = 1, n do
+        S = S + j
+    end
+end
+
+for _ = 1, 100 do
+    inner(10)
+end
+
+assert(S == 5500)
@@ -0,0 +1,33 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local jit_on = jit.status()
+assert(jit_on, "JIT must be on for this test")
+
+jit.opt.start("hotloop=3", "hotexit=3")
+
+-- The branch in both loops flips on each call, and the loops are run
+-- interleaved. The number of re-recordings is bounded for each loop.
+
+local function loop1(flag)
+    local s = 0
+    for i = 1, 50 do
+        if flag then s = s + i else s = s - i end
+    end
+    return s
+end
+
+local function loop2(flag)
+    local s = 0
+    for i = 1, 50 do
+        if flag then s = s + i else s = s - i end
+    end
+    return s
+end
+
+for k = 1, 40 do
+    local flag = k % 2 == 0
+    assert(loop1(flag) == (flag and 1275 or -1275))
+    assert(loop2(flag) == (flag and 1275 or -1275))
+end
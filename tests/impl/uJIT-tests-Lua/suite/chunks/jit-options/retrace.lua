@@ -0,0 +1,23 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local jit_on = jit.status()
+assert(jit_on, "JIT must be on for this test")
+
+jit.opt.start("hotloop=3", "hotexit=3")
+
+-- The root trace is recorded along the branch which is taken only during the
+-- first iterations. With retrace=0 the hot branch is compiled as a side trace,
+-- otherwise the root trace is re-recorded along the hot branch.
+
+local S = 0
+for i = 1, 100 do
+    if i <= 5 then
+        S = S - i
+    else
+        S = S + i
+    end
+end
+
+assert(S == 5020)
@@ -0,0 +1,49 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Allocations from traces are reported as [TRACE], see memprof sources.
+jit.off()
+
+local memprof = require("ujit.memprof")
+
+local function alloc_tables(n)
+    local t
+    for i = 1, n do
+        t = {i, i, i, i}
+    end
+    return t
+end
+
+local function alloc_strings(n)
+    local s
+    for i = 1, n do
+        s = string.rep("x", 100) .. i
+    end
+    return s
+end
+
+assert(not pcall(memprof.sample))
+assert(not pcall(memprof.sample, 0))
+assert(not pcall(memprof.report))
+
+-- Not running:
+assert(memprof.report(io.stdout) == false)
+
+assert(memprof.sample(1024) == true, "Unable to start sampling")
+assert(memprof.sample(1024) == false, "Repetitive start not possible")
+assert(memprof.start(0, "ujit-memprof.bin") == false,
+       "Streaming and sampling are mutually exclusive")
+
+alloc_tables(50000)
+alloc_strings(50000)
+
+assert(memprof.report(io.stdout) == true, "Unable to report")
+
+assert(memprof.stop() == true, "Unable to stop")
+assert(memprof.report(io.stdout) == false, "Samples are freed on stop")
+
+-- ...and restart sampling:
+assert(memprof.sample(1024) == true, "Unable to start sampling #2")
+alloc_tables(1000)
+assert(memprof.stop() == true, "Unable to stop #2")
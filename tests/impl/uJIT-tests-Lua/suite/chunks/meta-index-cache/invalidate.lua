@@ -0,0 +1,37 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Lookups through __index tables are cached by the interpreter. Every kind
+-- of change of the tables involved must be observed by the next lookup.
+
+local Base = {}
+Base.__index = Base
+function Base:f() return "Base" end
+
+local Derived = setmetatable({}, Base)
+Derived.__index = Derived
+
+local o = setmetatable({}, Derived)
+local r = {}
+
+for _ = 1, 3 do r[#r + 1] = o:f() end        -- Cache is filled.
+function Derived:f() return "Derived" end     -- Shadowed on a nearer level.
+r[#r + 1] = o:f()
+Derived.f = nil                               -- Unshadowed.
+r[#r + 1] = o:f()
+Base.f = nil                                  -- Removed.
+r[#r + 1] = tostring(o.f)
+Base.f = function() return "Base2" end        -- Re-added to a dead node.
+r[#r + 1] = o:f()
+Derived.__index = {f = function() return "Other" end} -- __index replaced.
+r[#r + 1] = o:f()
+setmetatable(o, Base)                         -- Metatable replaced.
+r[#r + 1] = o:f()
+for i = 1, 100 do Base["k" .. i] = i end      -- Rehash.
+r[#r + 1] = o:f()
+o.f = function() return "Own" end             -- Shadowed by the object.
+r[#r + 1] = o:f()
+r[#r + 1] = ("abc"):upper()                   -- Non-table values.
+
+print(table.concat(r, " "))
@@ -0,0 +1,35 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+--
+-- Time spent on aborted traces is accounted, too
+--
+
+jit.opt.start(0, "hotloop=2")
+
+local function aborts()
+    local f = io.tmpfile()
+    ujit.dump.aborts(f)
+    f:seek("set")
+    local total = f:read("*a"):match("TOTAL (%d+)")
+    f:close()
+    return tonumber(total)
+end
+
+local metrics = ujit.getmetrics()
+
+local n = 0
+for _ = 1, 20 do
+    -- NYI: Recording of coroutine.wrap aborts the trace.
+    n = n + coroutine.wrap(function() return 1 end)()
+end
+
+assert(aborts() > 0)
+metrics = ujit.getmetrics()
+
+assert(metrics.jit_compile_ns > 0)
+assert(metrics.jit_compile_ns_max > 0)
+
+-- Abort counters are reset together with the metrics.
+assert(aborts() == 0)
@@ -0,0 +1,28 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+--
+-- Time spent in the compiler is accounted and reset on retrieval
+--
+
+jit.opt.start(0, "hotloop=2")
+
+local metrics = ujit.getmetrics()
+
+local sum = 0
+for i = 1, 20 do
+    sum = sum + i
+end
+
+metrics = ujit.getmetrics()
+
+assert(metrics.jit_compile_ns > 0)
+assert(metrics.jit_compile_ns_max > 0)
+assert(metrics.jit_compile_ns_max <= metrics.jit_compile_ns)
+
+-- Nothing was compiled since the last retrieval:
+metrics = ujit.getmetrics()
+
+assert(metrics.jit_compile_ns == 0)
+assert(metrics.jit_compile_ns_max == 0)
@@ -0,0 +1,27 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+jit.opt.start(3, "hotloop=1")
+
+local buf = ujit.string.buffer()
+
+for i = 1, 100 do
+    buf:put(i, ","):putf("%d:%s;", i, "k")
+end
+
+jit.off()
+local expected = {}
+for i = 1, 100 do
+    expected[#expected + 1] = i .. "," .. i .. ":k;"
+end
+assert(buf:tostring() == table.concat(expected))
+jit.on()
+
+local n = 0
+for i = 1, 100 do
+    buf:reset()
+    buf:put("x", i)
+    n = n + #buf:tostring()
+end
+assert(n == 292)
@@ -0,0 +1,44 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local buf = ujit.string.buffer()
+
+assert(type(buf) == "userdata")
+assert(#buf == 0 and buf:tostring() == "" and tostring(buf) == "")
+
+-- put and putf return the buffer itself.
+assert(buf:put("a", 1, 2.5, "b") == buf)
+assert(buf:putf("[%d|%i|%s|%s|%%]", 42, 7.9, "x", 1.5) == buf)
+assert(buf:tostring() == "a12.5b[42|7|x|1.5|%]")
+assert(#buf == #buf:tostring())
+
+-- putf understands everything string.format does.
+buf:reset():putf("%5.2f %x %q", 3.14159, 255, "a\nb")
+assert(buf:tostring() == string.format("%5.2f %x %q", 3.14159, 255, "a\nb"))
+
+assert(buf:reset() == buf and #buf == 0)
+
+-- Buffers are independent from each other and from string.format.
+local other = ujit.string.buffer()
+other:put("other")
+buf:put(string.format("%s", "fmt"), "!")
+assert(buf:tostring() == "fmt!" and other:tostring() == "other")
+
+-- Buffers created in a coroutine survive it.
+local co = coroutine.wrap(function()
+    local b = ujit.string.buffer()
+    b:put("abc")
+    return b
+end)
+local b = co()
+co = nil
+collectgarbage()
+b:put(string.rep("z", 100000))
+assert(#b == 100003)
+
+-- Errors.
+assert(not pcall(buf.put, buf, {}))
+assert(not pcall(buf.put, "not a buffer", "a"))
+assert(not pcall(buf.putf, buf))
+assert(not pcall(buf.tostring, io.stdout))
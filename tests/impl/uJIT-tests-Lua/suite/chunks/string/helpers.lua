@@ -0,0 +1,46 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local startswith = ujit.string.startswith
+local endswith = ujit.string.endswith
+local count = ujit.string.count
+
+assert(startswith("", ""))
+assert(startswith("abc", ""))
+assert(startswith("abc", "a"))
+assert(startswith("abc", "abc"))
+assert(not startswith("abc", "abcd"))
+assert(not startswith("abc", "b"))
+assert(not startswith("", "a"))
+assert(startswith("a\0b", "a\0"))
+
+assert(endswith("", ""))
+assert(endswith("abc", ""))
+assert(endswith("abc", "c"))
+assert(endswith("abc", "abc"))
+assert(not endswith("abc", "0abc"))
+assert(not endswith("abc", "b"))
+assert(not endswith("", "a"))
+assert(endswith("a\0b", "\0b"))
+
+assert(count("", ",") == 0)
+assert(count("abc", ",") == 0)
+assert(count(",a,,b,", ",") == 4)
+assert(count("aaaa", "aa") == 2)
+assert(count("aaa", "aa") == 1)
+assert(count("ab==cd==", "==") == 2)
+assert(count("a\0b\0", "\0") == 2)
+
+-- Numbers are coerced to strings
+assert(startswith(12345, 12))
+assert(endswith(12345, "45"))
+assert(count(1001, 0) == 2)
+
+local ok, err = pcall(count, "abc", "")
+assert(not ok and err:match("empty substring"))
+
+ok = pcall(startswith, "abc")
+assert(not ok)
+ok = pcall(endswith, nil, "abc")
+assert(not ok)
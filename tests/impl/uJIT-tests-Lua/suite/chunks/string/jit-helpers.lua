@@ -0,0 +1,18 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+jit.opt.start("jitcat", "hotloop=1")
+
+local startswith = ujit.string.startswith
+local endswith = ujit.string.endswith
+local count = ujit.string.count
+
+for i = 1, 200 do
+    local s = "key" .. i .. "=a,b,c"
+    assert(startswith(s, "key"))
+    assert(not startswith(s, "value"))
+    assert(endswith(s, ",c"))
+    assert(not endswith(s, "key"))
+    assert(count(s, ",") == 2)
+end
@@ -0,0 +1,24 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+jit.opt.start("jitcat", "hotloop=1")
+
+local lines = { "ab,c,,def", "", ",x,", "nosep", "1,22,333," }
+local expected = {
+    { "ab", "c", "", "def" },
+    { "" },
+    { "", "x", "" },
+    { "nosep" },
+    { "1", "22", "333", "" },
+}
+
+for i = 1, 200 do
+    local k = i % #lines + 1
+    local n = 0
+    for token in ujit.string.split(lines[k], ",") do
+        n = n + 1
+        assert(token == expected[k][n])
+    end
+    assert(n == #expected[k])
+end
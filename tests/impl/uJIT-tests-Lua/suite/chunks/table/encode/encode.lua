@@ -0,0 +1,79 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local encode, decode = ujit.table.encode, ujit.table.decode
+
+local function roundtrip(v)
+    local s = encode(v)
+    assert(type(s) == "string")
+    return decode(s)
+end
+
+-- Scalars.
+assert(roundtrip(nil) == nil)
+assert(roundtrip(true) == true and roundtrip(false) == false)
+for _, n in ipairs({ 0, 1, -1, 42, 2^31 - 1, -2^31, 2^31, 2^53, 0.1, -1e300,
+                     1/0, -1/0 }) do
+    assert(roundtrip(n) == n)
+end
+assert(1 / roundtrip(-0) < 0)
+local nan = roundtrip(0/0)
+assert(nan ~= nan)
+assert(roundtrip("") == "")
+assert(roundtrip("foo\0bar") == "foo\0bar")
+
+-- Tables: array and hash parts, holes, non-string keys.
+local t = roundtrip({ 1, 2, nil, 4, x = "x", [1.5] = true, [false] = 0,
+                      [2^40] = "big", nested = { { {} } } })
+assert(t[1] == 1 and t[2] == 2 and t[3] == nil and t[4] == 4)
+assert(t.x == "x" and t[1.5] == true and t[false] == 0 and t[2^40] == "big")
+assert(type(t.nested[1][1]) == "table" and next(t.nested[1][1]) == nil)
+
+-- Shared references and cycles are preserved.
+local shared = { "shared" }
+local c = { a = shared, b = shared, list = { shared, shared } }
+c.self = c
+local d = roundtrip(c)
+assert(d.a == d.b and d.list[1] == d.a and d.list[2] == d.a)
+assert(d.a[1] == "shared" and d.self == d and d ~= c)
+
+-- Repeated strings are written only once.
+local reps = {}
+for i = 1, 100 do reps[i] = ("long string value "):rep(100) end
+assert(#encode(reps) < #reps[1] * 2)
+
+-- Metatables are not serialized.
+assert(getmetatable(roundtrip(setmetatable({}, {}))) == nil)
+
+-- Errors.
+assert(not pcall(encode))
+assert(not pcall(encode, print))
+assert(not pcall(encode, { function() end }))
+assert(not pcall(encode, { coroutine.create(print) }))
+assert(not pcall(encode, { newproxy() }))
+assert(not pcall(decode, 1))
+assert(not pcall(decode, ""))
+assert(not pcall(decode, encode({ 1, 2, 3 }):sub(1, -2)))
+assert(not pcall(decode, encode("foo") .. "x"))
+
+-- Crafted number keys: -0 is normalized to +0, NaN is rejected.
+local mzero = encode(-0)
+assert(mzero == "\4" .. string.char(0, 0, 0, 0, 0, 0, 0, 0x80))
+local tt = decode("\6\0\3" .. mzero .. "\5\1a" .. "\2\5\1b" .. "\2\5\1c")
+local nkeys = 0
+for k in pairs(tt) do
+    nkeys = nkeys + 1
+    assert(k == 0 and 1 / k > 0 or k == true)
+end
+assert(nkeys == 2 and tt[0] == "a" and tt[true] == "c")
+assert(not pcall(decode, "\6\0\1" .. encode(0/0) .. "\5\1a"))
+
+local deep = {}
+local cur = deep
+for _ = 1, 10000 do
+    cur[1] = {}
+    cur = cur[1]
+end
+local ok, err = pcall(encode, deep)
+assert(not ok and err:match("too deep"))
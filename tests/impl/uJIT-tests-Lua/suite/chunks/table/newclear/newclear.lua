@@ -0,0 +1,37 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local new, clear = ujit.table.new, ujit.table.clear
+
+-- Preallocated tables are empty.
+for _, sizes in ipairs({ {0, 0}, {1, 0}, {0, 1}, {17, 5}, {-1, -1} }) do
+    local t = new(sizes[1], sizes[2])
+    assert(type(t) == "table")
+    assert(next(t) == nil)
+    assert(getmetatable(t) == nil)
+end
+
+-- Clearing keeps the table usable.
+local t = new(4, 4)
+for i = 1, 4 do t[i] = i end
+t.foo, t.bar = "foo", "bar"
+clear(t)
+assert(next(t) == nil and #t == 0)
+t[1], t.baz = 1, "baz"
+assert(t[1] == 1 and t.baz == "baz" and ujit.table.size(t) == 2)
+
+-- Metatables survive clearing.
+local mt = { __index = function() return 42 end }
+local m = setmetatable({ 1, x = 2 }, mt)
+clear(m)
+assert(rawget(m, 1) == nil and m.x == 42 and getmetatable(m) == mt)
+
+-- Errors.
+assert(not pcall(new, "x", 1))
+assert(not pcall(new, 1))
+assert(not pcall(new, 1e9, 0))
+assert(not pcall(new, 0, 1e9))
+assert(not pcall(clear, 1))
+local ok, err = pcall(clear, ujit.immutable({ 1 }))
+assert(not ok and err:match("immutable"))
@@ -0,0 +1,27 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+-- Keys inserted with NEWREF are removed by clear, references to them
+-- must not be forwarded across the call.
+
+jit.opt.start(3, "hotloop=1")
+
+local clear = ujit.table.clear
+
+local function run()
+    local s = 0
+    for i = 1, 100 do
+        local t = {y = 0}
+        t.x = i
+        clear(t)
+        t.y = i
+        s = s + (t.x or 0) + t.y
+    end
+    return s
+end
+
+local compiled = run()
+jit.off()
+assert(compiled == run())
+assert(compiled == 5050)
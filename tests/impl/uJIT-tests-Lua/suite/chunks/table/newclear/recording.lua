@@ -0,0 +1,37 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+jit.opt.start(3, "hotloop=1")
+
+local new, clear = ujit.table.new, ujit.table.clear
+
+-- Constant sizes are recorded as TNEW, loads are not forwarded across clear.
+local s = 0
+for i = 1, 100 do
+    local t = new(4, 2)
+    t[1] = i
+    t.x = i
+    clear(t)
+    s = s + (t[1] or 0) + (t.x or 0)
+    t[2] = 1
+    s = s + t[2]
+end
+assert(s == 100)
+
+-- Variable sizes are recorded as a call.
+local n = 0
+for i = 1, 100 do
+    local t = new(i, i % 7)
+    n = n + #t
+end
+assert(n == 0)
+
+-- Tables created from templates are not folded to their initial content.
+local k = 0
+for _ = 1, 100 do
+    local t = { a = 1 }
+    clear(t)
+    k = k + (t.a or 2)
+end
+assert(k == 200)
@@ -93,3 +93,65 @@ $tester->run('any.lua', args => '-Xitern=on -b-')
     ->stdout_has('ITERN')
     ->stdout_has_no('ITERC')
 ;
+
+# -X bcopt=...
+$tester->run('bcopt.lua', args => '-Xbcopt=enable')
+    ->exit_not_ok('Unsupported value')
+    ->exit_without_coredump
+    ->stderr_has('Unknown value')
+;
+
+$tester->run('bcopt.lua', args => '-Xbcopt=off -b-')
+    ->exit_ok
+    ->stdout_matches(qr/KSHORT\s+1\s+1\n\d+\s+JMP/)
+;
+
+$tester->run('bcopt.lua', args => '-Xbcopt=on -b-')
+    ->exit_ok
+    ->stdout_matches(qr/KSHORT\s+1\s+1\n\d+\s+RET1/)
+;
+
+$tester->run('bcopt-thread.lua', args => '-Xbcopt=off -b-')
+    ->exit_ok
+    ->stdout_matches(qr/0008\s+JMP\s+\d+\s+=>\s+0010\n0009\s+KPRI.+\n0010\s+JMP\s+\d+\s+=>\s+0014\n/)
+;
+
+$tester->run('bcopt-thread.lua', args => '-Xbcopt=on -b-')
+    ->exit_ok
+    ->stdout_matches(qr/0008\s+JMP\s+\d+\s+=>\s+0014\n0009\s+KPRI.+\n0010\s+JMP\s+\d+\s+=>\s+0014\n/)
+;
+
+$tester->run('bcopt-thread.lua', args => '-Xbcopt=on')
+    ->exit_ok
+;
+
+# -X superins=...
+$tester->run('superins.lua', args => '-Xsuperins=enable')
+    ->exit_not_ok('Unsupported value')
+    ->exit_without_coredump
+    ->stderr_has('Unknown value')
+;
+
+$tester->run('superins.lua', args => '-b-')
+    ->exit_ok
+    ->stdout_has_no('TGETSS')
+;
+
+$tester->run('superins.lua', args => '-Xsuperins=off -b-')
+    ->exit_ok
+    ->stdout_has_no('TGETSS')
+;
+
+# Fusion is compiled in only with UJIT_ENABLE_SUPERINS=ON.
+if ($ENV{UJIT_SUPERINS}) {
+    $tester->run('superins.lua', args => '-Xsuperins=on -b-')
+        ->exit_ok
+        ->stdout_matches(qr/TGETSS.+\n\d+\s+TGETSS.+\n\d+\s+TGETS\s/)
+    ;
+} else {
+    $tester->run('superins.lua', args => '-Xsuperins=on -b-')
+        ->exit_not_ok('Unsupported in this build')
+        ->exit_without_coredump
+        ->stderr_has('Not supported in this build')
+    ;
+}
@@ -0,0 +1,24 @@
+#!/usr/bin/perl
+#
+# Tests for PHIs which do not fit into registers.
+# Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+# Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+use 5.010;
+use warnings;
+use strict;
+use lib './lib';
+
+use UJit::Test;
+
+my $tester = UJit::Test->new(
+    chunks_dir => './chunks/compiler-phi',
+);
+
+for my $chunk ('rotate.lua', 'swap.lua') {
+    $tester->run($chunk, jit => 1)
+        ->exit_ok
+        ->stdout_has_no('NYIPHI')
+        ->stdout_has('---- TOTAL 0')
+    ;
+}
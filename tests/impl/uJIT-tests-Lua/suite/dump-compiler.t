@@ -26,12 +26,20 @@ $tester->run('bindings.lua', jit => 1)
     ->stdout_has('->LOOP')
     ->stdout_has('->0')
     ->stdout_has('->1')
+    ->stdout_has('TRACE 1 exits')
+    ->stdout_has('---- ABORTS')
 ;
 
 $tester->run('bindings.lua', jit => 0)
     ->exit_ok
     ->stdout_has_no('TRACE 1 IR')
     ->stdout_has_no('TRACE 1 mcode')
+    ->stdout_has_no('TRACE 1 exits')
+;
+
+$tester->run('exits.lua', jit => 1)
+    ->exit_ok
+    ->stdout_matches(qr/TRACE 1 exits\n#\d+\s+20\n---- TOTAL 20\n/)
 ;
 
 #
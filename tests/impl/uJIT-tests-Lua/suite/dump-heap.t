@@ -0,0 +1,27 @@
+#!/usr/bin/perl
+#
+# Tests for dumping heap snapshots.
+# Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+# Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+use 5.010;
+use warnings;
+use strict;
+use lib './lib';
+
+use UJit::Test;
+
+my $tester = UJit::Test->new(
+    chunks_dir => './chunks/dump-heap',
+);
+
+$tester->run('heap.lua')
+    ->exit_ok
+    # Prologue and format version:
+    ->stdout_matches(qr/\Aujh\x01\x00\x00\x00/)
+    # Names of strings are truncated to 64 bytes:
+    ->stdout_has('HEAPDUMP_MARKER_' . ('z' x 48))
+    ->stdout_has_no('HEAPDUMP_MARKER_' . ('z' x 49))
+    # Epilogue:
+    ->stdout_matches(qr/\xff\z/)
+;
@@ -0,0 +1,34 @@
+#!/usr/bin/perl
+#
+# Tests for emitting information about traces for Linux perf.
+# Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+# Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+use 5.010;
+use warnings;
+use strict;
+use lib './lib';
+
+use UJit::Test;
+
+my $tester = UJit::Test->new(
+    chunks_dir => './chunks/dump-perf',
+);
+
+$tester->run('perf.lua', lua_args => 'map')
+    ->exit_ok
+    ->stdout_matches(qr/^[0-9a-f]+ [0-9a-f]+ TRACE_1 .+perf\.lua:14$/m)
+    ->stdout_matches(qr/^[0-9a-f]+ [0-9a-f]+ TRACE_2 .+perf\.lua:25$/m)
+;
+
+$tester->run('perf.lua', lua_args => 'jitdump')
+    ->exit_ok
+    ->stdout_matches(qr/^DTiJ/)
+    ->stdout_has("TRACE_1 ")
+    ->stdout_has("TRACE_2 ")
+;
+
+$tester->run('perf.lua', lua_args => 'elf')
+    ->exit_not_ok
+    ->stderr_has('invalid option')
+;
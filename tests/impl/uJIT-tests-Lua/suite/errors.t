@@ -1,6 +1,6 @@
 #!/usr/bin/perl
 #
-# Extra tests for error messages.
+# Extra tests for error messages and error handling.
 # Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
 # Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
 
@@ -16,3 +16,6 @@ my $tester = UJit::Test->new(
 );
 
 $tester->run('errors.lua')->exit_ok;
+
+$tester->run('unwind.lua')->exit_ok;
+$tester->run('unwind.lua', args => '-joff')->exit_ok;
@@ -9,6 +9,8 @@ use warnings;
 use strict;
 use lib './lib';
 
+use File::Temp qw/tempfile/;
+
 use UJit::Test;
 
 sub _run_tests_group {
@@ -43,9 +45,15 @@ my $tester = UJit::Test->new(
 );
 
 my @tarray = (
+    'callback.lua',
     'gcfin_table_reallocation.lua',
+    'loadtypes-cycles.lua',
 );
 
 $tester->run($_)->exit_ok() for (@tarray);
 
+my (undef, $types_file) = tempfile(UNLINK => 1);
+$tester->run('savetypes.lua', lua_args => "save $types_file")->exit_ok();
+$tester->run('savetypes.lua', lua_args => "load $types_file")->exit_ok();
+
 exit;
@@ -15,6 +15,10 @@ use constant {
     NOHREFK_CHUNK_NAME => 'nohrefk.lua',
     NORETL_CHUNK_NAME  => 'noretl.lua',
     JITCAT_CHUNK_NAME  => 'jitcat.lua',
+    RETRACE_CHUNK_NAME => 'retrace.lua',
+    RETRACE_INNER_CHUNK_NAME => 'retrace-inner.lua',
+    RETRACE_LIMIT_CHUNK_NAME => 'retrace-limit.lua',
+    FUSE_CHUNK_NAME    => 'fuse.lua',
 };
 
 my $tester = UJit::Test->new(
@@ -129,4 +133,81 @@ $tester->run(JITCAT_CHUNK_NAME, jit => 0)
     ->stderr_has(q/JIT must be on/)
 ;
 
+#
+# Test presence/absence of fusion of cdata addresses into memory operands
+#
+
+my $xload_fused = qr/movsd xmm\d+, qword \[r\w+\+r\w+\+0x10\]/;
+
+my @opt_fuse_not_emitted = (
+    '-p-',         # Default optimization mode
+    '-p- -O-fuse', # Explicitly turned off
+);
+
+foreach my $opt (@opt_fuse_not_emitted) {
+    $tester->run(FUSE_CHUNK_NAME, args => $opt)
+        ->exit_ok
+        ->stdout_matches_no($xload_fused)
+    ;
+}
+
+my @opt_fuse_emitted = (
+    '-p- -Ofuse',  # Explicitly turned on, spelling #1
+    '-p- -O+fuse', # Explicitly turned on, spelling #2
+    '-p- -O4',     # Enabled at -O4
+);
+
+foreach my $opt (@opt_fuse_emitted) {
+    $tester->run(FUSE_CHUNK_NAME, args => $opt)
+        ->exit_ok
+        ->stdout_matches($xload_fused)
+    ;
+}
+
+#
+# Test re-recording of root traces along hot side exits
+#
+
+my @opt_retrace_side = (
+    '-p-',             # Default value
+    '-p- -Oretrace=0', # Explicitly turned off
+);
+
+foreach my $opt (@opt_retrace_side) {
+    $tester->run(RETRACE_CHUNK_NAME, args => $opt)
+        ->exit_ok
+        ->stdout_has(q/TRACE 2 start 1\/1/)
+        ->stdout_has_no(q/TRACE 3 start/)
+    ;
+}
+
+$tester->run(RETRACE_CHUNK_NAME, args => '-p- -Oretrace=1')
+    ->exit_ok
+    ->stdout_has_no(q/TRACE 2 start 1\/1/)
+    ->stdout_has(qr/TRACE 2 start .+retrace.lua:15/)
+;
+
+# Exits from an inner loop do not trigger re-recording.
+$tester->run(RETRACE_INNER_CHUNK_NAME, args => '-p- -Oretrace=1')
+    ->exit_ok
+    ->stdout_has(qr/TRACE 2 start 1\/\d+ /)
+    ->stdout_has_no(qr/TRACE [2-9] start \S+retrace-inner.lua:16/)
+;
+
+# Each loop is re-recorded at most 'retrace' times, i.e. at most 1 + retrace
+# root traces are recorded for each loop.
+foreach my $retrace (1, 2) {
+    foreach my $line (15, 23) {
+        my $start = qr/TRACE \d+ start \S+retrace-limit.lua:$line\n/;
+        my $n = $retrace + 1;
+        my $m = $retrace + 2;
+
+        $tester->run(RETRACE_LIMIT_CHUNK_NAME, args => "-p- -Oretrace=$retrace")
+            ->exit_ok
+            ->stdout_matches(qr/(?:$start[\s\S]*?){$n}/)
+            ->stdout_matches_no(qr/(?:$start[\s\S]*?){$m}/)
+        ;
+    }
+}
+
 exit;
@@ -24,6 +24,7 @@ use constant {
     DEFAULT_PROFILE_MOCKER_NAME => 'ujit-mock-profile',
     DEFAULT_PROFILE_PARSER_NAME => 'ujit-parse-profile',
     DEFAULT_MEMPROF_PARSER_NAME => 'ujit-parse-memprof',
+    DEFAULT_HEAPDUMP_PARSER_NAME => 'ujit-parse-heapdump',
     FIND_DEPTH_LEVEL => 10,
     PROJECT_ROOT_ANCHOR => 'src',
 };
@@ -37,9 +38,10 @@ our @UJIT_TOOLS_SYM;
 
 BEGIN {
     %UJIT_TOOLS = (
-        PROF_MOCKER    => 'mocker',
-        PROF_PARSER    => 'parser',
-        MEMPROF_PARSER => 'memprof',
+        PROF_MOCKER     => 'mocker',
+        PROF_PARSER     => 'parser',
+        MEMPROF_PARSER  => 'memprof',
+        HEAPDUMP_PARSER => 'heapdump',
     );
     @UJIT_TOOLS_SYM = (keys %UJIT_TOOLS);
 }
@@ -119,7 +121,10 @@ sub new
             },
             memprof => {
                 name => $arg{memprof_name} // DEFAULT_MEMPROF_PARSER_NAME,
-            }
+            },
+            heapdump => {
+                name => $arg{heapdump_name} // DEFAULT_HEAPDUMP_PARSER_NAME,
+            },
         },
 
         # Create a special object for situations when a test wants
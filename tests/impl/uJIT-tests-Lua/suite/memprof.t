@@ -22,4 +22,11 @@ $tester->run('memprof.lua')
 
 $tester->run('duration.lua')->exit_ok;
 
+# Collapsed stacks, outermost frame first, estimated bytes at the end:
+$tester->run('sample.lua')
+    ->exit_ok
+    ->stdout_matches(qr/^\S*sample\.lua:\d+;\S*sample\.lua:13 \d+$/m)
+    ->stdout_matches(qr/^\S*sample\.lua:\d+;\S*sample\.lua:21 \d+$/m)
+;
+
 exit;
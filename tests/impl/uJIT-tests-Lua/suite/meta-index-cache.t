@@ -0,0 +1,28 @@
+#!/usr/bin/perl
+#
+# Validity of the cache of __index resolutions in the interpreter.
+# Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+# Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+use 5.010;
+use warnings;
+use strict;
+use lib './lib';
+
+use UJit::Test;
+
+my $tester = UJit::Test->new(
+    chunks_dir => './chunks/meta-index-cache',
+);
+
+my $expected = 'Base Base Base Derived Base nil Base2 Other Base2 Base2 Own ABC';
+
+$tester->run('invalidate.lua', args => '-joff')
+    ->exit_ok
+    ->stdout_has($expected)
+;
+
+$tester->run('invalidate.lua')
+    ->exit_ok
+    ->stdout_has($expected)
+;
@@ -0,0 +1,27 @@
+#!/usr/bin/perl
+#
+# Tests for metrics of time spent in the JIT compiler.
+# Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+# Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+use 5.010;
+use warnings;
+use strict;
+use lib './lib';
+
+use UJit::Test;
+
+my $tester = UJit::Test->new(
+    chunks_dir => './chunks/metrics-jit-compile',
+);
+
+my @chunks = qw/
+abort.lua
+loop.lua
+/;
+
+foreach my $chunk (@chunks) {
+    $tester->run($chunk)->exit_ok;
+}
+
+exit;
@@ -23,9 +23,35 @@ $tester->run('jit-trim.lua', args => '-p-')
     ->stdout_has(qr/uj_str_trim/)
     ->stdout_has(qr/TRACE.+?stop -> loop/);
 
+$tester->run('jit-split.lua', args => '-p-')
+    ->exit_ok
+    ->stdout_has_no(qr/TRACE.+?abort.+?NYI/)
+    ->stdout_has(qr/CALLS.+?lj_ujit_string_splitter/)
+    ->stdout_has(qr/CALLN.+?uj_cstr_find/)
+    ->stdout_has(qr/SNEW/);
+
+$tester->run('jit-helpers.lua', args => '-p-')
+    ->exit_ok
+    ->stdout_has_no(qr/TRACE.+?abort.+?/)
+    ->stdout_has(qr/CALLN.+?uj_str_startswith/)
+    ->stdout_has(qr/CALLN.+?uj_str_endswith/)
+    ->stdout_has(qr/CALLN.+?uj_str_count/)
+    ->stdout_has(qr/TRACE.+?stop -> loop/);
+
 $tester->run('find.lua')->exit_ok;
 $tester->run('trim.lua')->exit_ok;
 $tester->run('split.lua')->exit_ok;
+$tester->run('helpers.lua')->exit_ok;
+$tester->run('buffer.lua')->exit_ok;
+
+$tester->run('buffer-recording.lua', args => '-p-')
+    ->exit_ok
+    ->stdout_has_no(qr/TRACE.+?abort.+?/)
+    ->stdout_has(qr/TRACE.+?stop -> loop/)
+    ->stdout_has(qr/CALLS.+?uj_strbuf_put_int/)
+    ->stdout_has(qr/CALLS.+?uj_strbuf_put_str/)
+    ->stdout_has(qr/CALLS.+?uj_strbuf_reset/)
+    ->stdout_has(qr/CALLL.+?uj_str_frombuf/);
 
 # string.find tests
 
@@ -262,6 +262,31 @@ $tester->run('size/throw_on_recording.lua', args => '-p-')
   ->stdout_has(qr/TRACE.+?asynchronous abort/)
   ->stderr_has(q/bad argument #1 to 'size' (table expected/);
 
+# ujit.table.encode and ujit.table.decode tests
+$tester->run('encode/encode.lua')
+  ->exit_ok()
+  ->exit_without_coredump();
+
+# ujit.table.new and ujit.table.clear tests
+$tester->run('newclear/newclear.lua')
+  ->exit_ok()
+  ->exit_without_coredump();
+
+$tester->run('newclear/recording.lua', args => '-p-')
+  ->exit_ok()
+  ->stdout_has_no(qr/TRACE.+?abort.+?/)
+  ->stdout_has(qr/TRACE.+?stop -> loop/)
+  ->stdout_has(qr/tab TNEW   #5    #1/)
+  ->stdout_has(qr/CALLS.+?lj_tab_new_ah/)
+  ->stdout_has(qr/CALLS.+?lj_tab_clear/);
+
+$tester->run('newclear/newref.lua', args => '-p-')
+  ->exit_ok()
+  ->stdout_has_no(qr/TRACE.+?abort.+?/)
+  ->stdout_has(qr/NEWREF\s+\d+\s+"x"/)
+  ->stdout_has(qr/CALLS.+?lj_tab_clear/)
+  ->stdout_has(qr/HREF\s+\d+\s+"x"/);
+
 $tester->run('debug.lua')
   ->exit_ok();
 
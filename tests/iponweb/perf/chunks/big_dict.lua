@@ -0,0 +1,29 @@
+-- This performance test is mostly aimed at assessing growth of and lookups
+-- in large hash parts, like the ones of lookup dictionaries with millions
+-- of entries. The dictionary is built from scratch, so the hash part goes
+-- through every power-of-two size on its way.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local N = tonumber(arg and arg[1]) or 1e6
+local ROUNDS = 3
+
+local keys = {}
+for i = 1, N do
+  keys[i] = "key" .. i
+end
+
+local acc = 0
+for _ = 1, ROUNDS do
+  local dict = {}
+  for i = 1, N do
+    dict[keys[i]] = i
+    dict[i * 7 + 0.5] = i
+  end
+  for i = 1, N, 3 do
+    acc = acc + dict[keys[i]] + dict[i * 7 + 0.5]
+  end
+end
+
+print(acc)
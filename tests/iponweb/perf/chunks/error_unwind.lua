@@ -0,0 +1,50 @@
+-- This performance test assesses raising and catching errors at high rates,
+-- e.g. when error()/pcall are used for reporting validation failures.
+-- In the "lua" mode, only Lua and VM frames are located between error() and
+-- the catching pcall. In the "c" mode, each error has to cross a C frame
+-- (a replacement function called by string.gsub), which requires a full
+-- unwinding of the host stack.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local MODE = arg and arg[1] or "lua"
+local N = tonumber(arg and arg[2]) or 1e6
+
+local function validate(record)
+    if type(record.id) ~= "number" then
+        error("bad id", 0)
+    end
+    return record.id
+end
+
+local current
+local function replace()
+    return tostring(validate(current))
+end
+
+local check
+if MODE == "lua" then
+    check = validate
+elseif MODE == "c" then
+    check = function(record)
+        current = record
+        return string.gsub("x", "x", replace)
+    end
+else
+    error("unknown mode: " .. MODE)
+end
+
+local records = {}
+for i = 1, 16 do
+    records[i] = { id = i % 4 ~= 0 and i or "?" }
+end
+
+local failed = 0
+for i = 1, N do
+    if not pcall(check, records[i % 16 + 1]) then
+        failed = failed + 1
+    end
+end
+
+print(failed)
@@ -0,0 +1,30 @@
+-- This performance test is mostly aimed at assessing interpretation of
+-- field chains (like cfg.server.limits.timeout) and consecutive field loads
+-- from the same object. Such code is compiled to sequences of TGETS which
+-- are subject to superinstruction fusion in the frontend, so the chunk is
+-- meaningful for the interpreter first of all. With a build configured
+-- with UJIT_ENABLE_SUPERINS=ON, compare the results of running it with
+-- -joff and -joff -Xsuperins=on to assess the effect.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local N = tonumber(arg and arg[1]) or 2e7
+
+local cfg = {
+  server = {
+    limits = {timeout = 1, retries = 2, backoff = 3},
+    name = "srv",
+  },
+}
+
+local point = {x = 1, y = 2, z = 3}
+
+local acc = 0
+for _ = 1, N do
+  local limits = cfg.server.limits
+  acc = acc + cfg.server.limits.timeout + limits.retries + limits.backoff
+  acc = acc + point.x + point.y + point.z
+end
+
+print(acc)
@@ -0,0 +1,42 @@
+-- This performance test is mostly aimed at assessing interpretation of
+-- class-style method dispatch, i.e. lookups which miss in the object and are
+-- resolved through __index tables of its metatable (and of the metatable's
+-- metatable in case of inheritance). Run it with -joff to assess the
+-- interpreter, which goes through the metamethod helpers on every access.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local N = tonumber(arg and arg[1]) or 1e7
+
+local Base = {}
+Base.__index = Base
+
+function Base.new(x)
+  return setmetatable({x = x}, Base)
+end
+
+function Base:get()
+  return self.x
+end
+
+local Derived = setmetatable({}, Base)
+Derived.__index = Derived
+
+function Derived.new(x)
+  return setmetatable({x = x}, Derived)
+end
+
+function Derived:twice()
+  return 2 * self.x
+end
+
+local b = Base.new(1)
+local d = Derived.new(2)
+
+local acc = 0
+for _ = 1, N do
+  acc = acc + b:get() + d:get() + d:twice()
+end
+
+print(acc)
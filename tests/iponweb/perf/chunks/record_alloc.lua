@@ -0,0 +1,23 @@
+-- This performance test is mostly aimed at assessing allocation and access
+-- of short-living record-like tables, i.e. tables with a few string keys
+-- created by table constructors. Small hash parts of such tables are
+-- colocated with the table object, so both creation and collection of
+-- a record cost a single allocation.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local N = tonumber(arg and arg[1]) or 1e7
+
+local function point(x, y)
+  return {x = x, y = y, z = 0}
+end
+
+local acc = 0
+for i = 1, N do
+  local p = point(i, -i)
+  local q = {id = i, pos = p, tag = "q"}
+  acc = acc + q.pos.x + q.pos.y + q.id
+end
+
+print(acc)
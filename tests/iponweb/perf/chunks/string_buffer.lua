@@ -0,0 +1,34 @@
+-- This performance test assesses assembling of output with string buffers:
+-- a list of records is serialized into a JSON-like string many times. Only
+-- the final strings are interned, intermediate pieces create no garbage.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local N = tonumber(arg and arg[1]) or 2e5
+
+local records = {}
+for i = 1, 16 do
+    records[i] = { id = i, name = "item" .. i, price = i * 1.25 }
+end
+
+local buf = ujit.string.buffer()
+
+local function serialize(recs)
+    buf:reset():put("[")
+    for i = 1, #recs do
+        local r = recs[i]
+        buf:putf('{"id":%d,"name":"%s","price":%s}', r.id, r.name, r.price)
+        if i < #recs then
+            buf:put(",")
+        end
+    end
+    return buf:put("]"):tostring()
+end
+
+local len = 0
+for _ = 1, N do
+    len = len + #serialize(records)
+end
+
+print(len)
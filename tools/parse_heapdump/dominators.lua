@@ -0,0 +1,162 @@
+-- Computing dominators and retained sizes of objects of a heap snapshot.
+--
+-- An object A dominates an object B if every path from the GC roots to B
+-- goes through A, i.e. B is collected as soon as A becomes unreachable.
+-- Retained size of an object is the total size of all objects it dominates
+-- (including itself). Dominators are computed with the iterative algorithm
+-- from "A Simple, Fast Dominance Algorithm" by Cooper, Harvey and Kennedy.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local M = {}
+
+-- Node 0 is a synthetic root referencing all GC roots, nodes 1..n are
+-- objects of the snapshot. Returns successors of each node.
+local function build_graph(snapshot)
+	local objects = snapshot.objects
+	local index = {}
+	local succ = {}
+
+	for i = 1, #objects do
+		index[objects[i].addr] = i
+	end
+
+	local function resolve(addrs)
+		local nodes = {}
+		for j = 1, #addrs do
+			-- References to the objects of the data state are dropped.
+			local node = index[addrs[j]]
+			if node then
+				nodes[#nodes + 1] = node
+			end
+		end
+		return nodes
+	end
+
+	succ[0] = resolve(snapshot.roots)
+	for i = 1, #objects do
+		succ[i] = resolve(objects[i].edges)
+	end
+
+	return succ
+end
+
+-- Returns nodes reachable from the root in reverse postorder and postorder
+-- numbers of the nodes.
+local function order_nodes(succ)
+	local postnum = {}
+	local order = {}
+	local visited = {[0] = true}
+	local stack_node = {0}
+	local stack_edge = {1}
+	local sp = 1
+	local n = 0
+
+	while sp > 0 do
+		local node = stack_node[sp]
+		local edge = stack_edge[sp]
+		local s = succ[node]
+
+		if edge <= #s then
+			stack_edge[sp] = edge + 1
+			local next_node = s[edge]
+			if not visited[next_node] then
+				visited[next_node] = true
+				sp = sp + 1
+				stack_node[sp] = next_node
+				stack_edge[sp] = 1
+			end
+		else
+			n = n + 1
+			postnum[node] = n
+			order[n] = node
+			stack_node[sp] = nil
+			stack_edge[sp] = nil
+			sp = sp - 1
+		end
+	end
+
+	-- Reverse to get reverse postorder:
+	local rpo = {}
+	for i = n, 1, -1 do
+		rpo[#rpo + 1] = order[i]
+	end
+
+	return rpo, postnum
+end
+
+-- Returns the immediate dominator of each reachable object (0 for objects
+-- dominated by the root only) and retained sizes of all reachable objects.
+function M.compute(snapshot)
+	local objects = snapshot.objects
+	local succ = build_graph(snapshot)
+	local rpo, postnum = order_nodes(succ)
+	local pred = {}
+
+	for i = 1, #rpo do
+		local node = rpo[i]
+		local s = succ[node]
+		for j = 1, #s do
+			local p = pred[s[j]]
+			if not p then
+				p = {}
+				pred[s[j]] = p
+			end
+			p[#p + 1] = node
+		end
+	end
+
+	local idom = {[0] = 0}
+
+	local function intersect(b1, b2)
+		while b1 ~= b2 do
+			while postnum[b1] < postnum[b2] do
+				b1 = idom[b1]
+			end
+			while postnum[b2] < postnum[b1] do
+				b2 = idom[b2]
+			end
+		end
+		return b1
+	end
+
+	local changed = true
+	while changed do
+		changed = false
+		for i = 2, #rpo do -- rpo[1] is the root
+			local node = rpo[i]
+			local new_idom
+			local p = pred[node]
+			for j = 1, #p do
+				local q = p[j]
+				if idom[q] ~= nil then
+					new_idom = new_idom and intersect(q, new_idom) or q
+				end
+			end
+			if idom[node] ~= new_idom then
+				idom[node] = new_idom
+				changed = true
+			end
+		end
+	end
+
+	local retained = {}
+	for i = 2, #rpo do
+		local node = rpo[i]
+		retained[node] = objects[node].size
+	end
+	-- Dominators precede dominated nodes in reverse postorder:
+	for i = #rpo, 2, -1 do
+		local node = rpo[i]
+		local dom = idom[node]
+		if dom ~= 0 then
+			retained[dom] = retained[dom] + retained[node]
+		end
+	end
+
+	idom[0] = nil
+	return idom, retained
+end
+
+return M
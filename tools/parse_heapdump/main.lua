@@ -0,0 +1,174 @@
+-- A tool for analysis of uJIT's heap snapshots.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local bufread    = require 'bufread'
+local heapdump   = require 'parse_heapdump'
+local dominators = require 'dominators'
+
+local string_format = string.format
+
+-- Quick and dirty version of https://github.com/mpeterv/argparse
+local function arg_parse(arg)
+	local res = {}
+	local i = 1
+	while i <= #arg do
+		-- Is it a key (i.e. starts with --, has another symbols)?
+		local is_key, key = arg[i]:match('^([-]+)(.+)')
+		if is_key then
+			local pos = key:find('=')
+			if pos then
+				res[key:sub(1, pos - 1)] = key:sub(pos + 1)
+			else -- try to consume the next arg:
+				local nextarg = arg[i + 1] or ''
+				local value = nextarg:match('^([^-].*)')
+				if value then
+					i = i + 1
+				end
+				res[key] = value or true
+			end
+		else
+			res[#res + 1] = arg[i]
+		end
+		i = i + 1
+	end
+	return res
+end
+
+local args = arg_parse{...}
+
+if args.help then
+	print [[
+ujit-parse-heapdump - analyzer of heap snapshots dumped with uJIT's
+                      ujit.dump.heap or luaE_dumpheap.
+
+SYNOPSIS
+
+ujit-parse-heapdump --dump heap.bin [options]
+
+Supported options are:
+
+  --dump    heap.bin     Path to uJIT heap snapshot [MANDATORY]
+  --memprof memprof.bin  Path to uJIT memprof stream recorded up to the
+                         moment of the snapshot, used for reporting
+                         allocation sites of objects
+  --top     N            Report N biggest retainers (default: 20)
+  --help                 Show this help and exit
+]]
+	os.exit(0)
+end
+
+if not args.dump then
+	error('FATAL: --dump /path/to/heap.bin is required')
+end
+
+local top = tonumber(args.top) or 20
+
+-- Allocation sites are recovered from the memprof stream: its final
+-- heap state maps addresses of live allocations to their locations.
+local function alloc_sites(fname)
+	if not fname then
+		return nil
+	end
+
+	local memprof = require 'parse_memprof'
+	local symtab  = require 'parse_symtab'
+
+	local reader  = bufread.new(fname)
+	local symbols = symtab.parse(reader)
+	local events  = memprof.parse(reader, symbols)
+	local sites   = {}
+
+	for addr, alloc in pairs(events.heap) do
+		sites[addr] = symtab.demangle(symbols, alloc[3])
+	end
+
+	return sites
+end
+
+local function format_site(sites, addr)
+	if not sites then
+		return ''
+	end
+	return sites[addr] or '?'
+end
+
+local snapshot = heapdump.parse(bufread.new(args.dump))
+local objects  = snapshot.objects
+local sites    = alloc_sites(args.memprof)
+local idom, retained = dominators.compute(snapshot)
+
+print('HEAP SUMMARY')
+local by_type = {}
+local types = {}
+local total_num, total_size = 0, 0
+for i = 1, #objects do
+	local obj = objects[i]
+	local t = by_type[obj.type]
+	if not t then
+		t = {num = 0, size = 0}
+		by_type[obj.type] = t
+		types[#types + 1] = obj.type
+	end
+	t.num  = t.num + 1
+	t.size = t.size + obj.size
+	total_num  = total_num + 1
+	total_size = total_size + obj.size
+end
+table.sort(types, function(t1, t2)
+	return by_type[t1].size > by_type[t2].size
+end)
+for i = 1, #types do
+	local t = by_type[types[i]]
+	print(string_format('%-10s %10d objects %12d bytes',
+		types[i], t.num, t.size))
+end
+print(string_format('%-10s %10d objects %12d bytes',
+	'total', total_num, total_size))
+print('')
+
+print('TOP RETAINERS')
+local nodes = {}
+for node, _ in pairs(idom) do
+	nodes[#nodes + 1] = node
+end
+table.sort(nodes, function(n1, n2)
+	if retained[n1] ~= retained[n2] then
+		return retained[n1] > retained[n2]
+	end
+	return n1 < n2
+end)
+print(string_format('%12s %10s %-10s %-18s %s',
+	'RETAINED', 'SELF', 'TYPE', 'ADDRESS', 'NAME'))
+for i = 1, math.min(top, #nodes) do
+	local obj = objects[nodes[i]]
+	print(string_format('%12d %10d %-10s %#-18x %s %s',
+		retained[nodes[i]], obj.size, obj.type, obj.addr,
+		obj.name, format_site(sites, obj.addr)))
+end
+print('')
+
+if sites then
+	print('ALLOCATION SITES')
+	local live = {}
+	local locs = {}
+	for i = 1, #objects do
+		local obj = objects[i]
+		local loc = format_site(sites, obj.addr)
+		if not live[loc] then
+			live[loc] = {num = 0, size = 0}
+			locs[#locs + 1] = loc
+		end
+		live[loc].num  = live[loc].num + 1
+		live[loc].size = live[loc].size + obj.size
+	end
+	table.sort(locs, function(l1, l2)
+		return live[l1].size > live[l2].size
+	end)
+	for i = 1, #locs do
+		print(string_format('%s: %d objects, %d bytes',
+			locs[i], live[locs[i]].num, live[locs[i]].size))
+	end
+	print('')
+end
@@ -0,0 +1,89 @@
+-- Parser of uJIT's heap snapshots.
+-- The format spec can be found in src/dump/uj_dump_heap.c.
+--
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+local string_format = string.format
+
+local UJH_MAGIC           = 'ujh'
+local UJH_CURRENT_VERSION = 1
+local UJH_EPILOGUE        = 0xff
+
+-- Bitwise negations of LJ_T* tags, see src/lj_obj.h.
+local TYPE_NAMES = {
+	[4]  = 'string',
+	[5]  = 'upvalue',
+	[6]  = 'thread',
+	[7]  = 'proto',
+	[8]  = 'function',
+	[9]  = 'trace',
+	[10] = 'cdata',
+	[11] = 'table',
+	[12] = 'userdata',
+}
+
+local M = {}
+
+local function parse_edges(reader)
+	local nedges = reader:read_uleb128()
+	local edges = {}
+
+	for i = 1, nedges do
+		edges[i] = reader:read_uleb128()
+	end
+
+	return edges
+end
+
+-- Returns a snapshot, which is a table with the following fields:
+--  * roots:   array of addresses of GC roots;
+--  * objects: array of objects, each object is a table with fields
+--             type, addr, size, edges (array of addresses), name.
+function M.parse(reader)
+	local magic   = reader:read_octets(3)
+	local version = reader:read_octets(1)
+	local _       = reader:read_octets(3) -- dummy-consume reserved bytes
+
+	if magic ~= UJH_MAGIC then
+		error('Bad UJH format prologue: ' .. tostring(magic))
+	end
+
+	if string.byte(version) ~= UJH_CURRENT_VERSION then
+		error(string_format(
+		     'UJH format version mismatch: the tool expects %d, but your data is %d',
+		     UJH_CURRENT_VERSION,
+		     string.byte(version)
+		))
+	end
+
+	local snapshot = {
+		roots   = parse_edges(reader),
+		objects = {},
+	}
+	local objects = snapshot.objects
+
+	while true do
+		local otype = reader:read_octet()
+
+		if otype == nil then
+			error('Unexpected end of the heap snapshot')
+		end
+
+		if otype == UJH_EPILOGUE then
+			break
+		end
+
+		objects[#objects + 1] = {
+			type  = TYPE_NAMES[otype] or string_format('type#%d', otype),
+			addr  = reader:read_uleb128(),
+			size  = reader:read_uleb128(),
+			edges = parse_edges(reader),
+			name  = reader:read_string(),
+		}
+	end
+
+	return snapshot
+end
+
+return M
@@ -0,0 +1,33 @@
+-- This is a part of uJIT's testing suite.
+-- Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+-- Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+jit.off()
+
+local fname_dump    = arg[1]
+local fname_memprof = arg[2]
+
+assert(type(fname_dump) == 'string', 'Please specify dump file')
+assert(type(fname_memprof) == 'string', 'Please specify memprof file')
+
+local memprof = require('ujit.memprof')
+local started, fname_real = memprof.start(0, fname_memprof)
+assert(started == true, 'Unable to start memprof')
+
+local function make_payload()
+	local t = {}
+	for i = 1, 500 do
+		t[i] = {string.rep('x', 100) .. i}
+	end
+	return t
+end
+
+retainer = {payload = make_payload()}
+
+assert(memprof.stop() == true, 'Unable to stop memprof')
+
+local f = assert(io.open(fname_dump, 'wb'))
+ujit.dump.heap(f)
+f:close()
+
+print(fname_real)
@@ -0,0 +1,67 @@
+#!/usr/bin/perl -w
+#
+# Tests for uJIT heap snapshot analyzer.
+# Copyright (C) 2020-2025 LuaVela Authors. See Copyright Notice in COPYRIGHT
+# Copyright (C) 2015-2020 IPONWEB Ltd. See Copyright Notice in COPYRIGHT
+
+use 5.010;
+use warnings;
+use strict;
+
+# for in-source runs
+use lib '../../tests/impl/uJIT-tests-Lua/suite/lib';
+
+use UJit::Test;
+use Cwd;
+
+my $cwd        = Cwd::cwd();
+my $tools_dir  = $ENV{TOOLS_BIN_DIR} // "$cwd/..";
+my $chunks_dir = $ENV{CHUNKS_DIR} // "$cwd/chunks";
+my $ujit_dir   = $ENV{UJIT_BIN_DIR} // "$cwd/../../src/";
+my $ujit_bin   = "$ujit_dir/ujit";
+
+my $tester = UJit::Test->new(
+    tools_dir => $tools_dir,
+    ujit_dir => $ujit_dir
+);
+
+my $chunk_name   = 'heapdump.lua';
+my $fname_dump   = "$cwd/ujit-heapdump.bin";
+my $fname_stub   = "$cwd/ujit-heapdump-memprof.bin";
+my $memprof      = `$ujit_bin $chunks_dir/$chunk_name $fname_dump $fname_stub`;
+chomp($memprof);
+
+die "Unable to dump a heap" unless -f $fname_dump;
+die "Unable to record a memprof" unless $memprof =~ /^\Q$fname_stub\E/;
+
+$tester->run_tool(
+    UJit::Test::HEAPDUMP_PARSER, 'smoke_run', args => '--help'
+)->exit_ok;
+
+$tester->run_tool(UJit::Test::HEAPDUMP_PARSER, 'output_check',
+    args => sprintf('--dump %s --top 5', $fname_dump))
+    ->exit_ok
+    ->stdout_matches(qr/
+        HEAP\sSUMMARY.+
+            ^table\s+\d+\sobjects.+
+            ^string\s+\d+\sobjects.+
+        TOP\sRETAINERS.+
+            # retainer, which dominates the payload:
+            ^\s+(\d{5,})\s+\d+\stable\s.+
+            # payload, which dominates 500 tables and strings:
+            ^\s+(\d{5,})\s+8\d{3}\stable\s
+    /msx)
+;
+
+$tester->run_tool(UJit::Test::HEAPDUMP_PARSER, 'alloc_sites',
+    args => sprintf('--dump %s --memprof %s', $fname_dump, $memprof))
+    ->exit_ok
+    # Following depend on line numbering in the chunk, refactor with care:
+    ->stdout_matches(qr/
+        ALLOCATION\sSITES.+
+            \Q$chunk_name\E:17,\sline\s20:\s1000\sobjects
+    /sx)
+;
+
+unlink $fname_dump;
+unlink $memprof;
@@ -50,9 +50,12 @@ $tester->run_tool(UJit::Test::MEMPROF_PARSER, 'output_check',
             \Q$mocker_name\E:5.+? 100.+
             \Q$mocker_name\E:5.+? 60.+
         DEALLOCATIONS.+
+            INTERNAL.+
+            Overrides.+
+                \Q$mocker_name\E:5,\sline\s8.+
             \Q$mocker_name\E:5.+? 50.+
             Overrides.+
-                \Q$mocker_name\E:5,\sline\s8
+                \Q$mocker_name\E:5,\sline\s12
     /sx)
 ;
 
@@ -18,6 +18,10 @@ else
         cp -a "$TOOLS_DIR/parse_memprof" "$TOOLS_BIN_DIR"
         cp "$TOOLS_DIR/ujit-parse-memprof" "$TOOLS_BIN_DIR"
 
+        rm -rf "$TOOLS_BIN_DIR/parse_heapdump"
+        cp -a "$TOOLS_DIR/parse_heapdump" "$TOOLS_BIN_DIR"
+        cp "$TOOLS_DIR/ujit-parse-heapdump" "$TOOLS_BIN_DIR"
+
         cp "$TOOLS_DIR/ujit-mock-memprof.lua" "$TOOLS_BIN_DIR"
     fi
 
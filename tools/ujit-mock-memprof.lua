@@ -22,12 +22,19 @@ assert(type(argv[1]) == "string", "Output fname required on the command line")
 
 local duration = 0 -- infinite
 local fname_stub = argv[1]
+-- Make the profile independent of the GC pacing: No collection steps
+-- during the payload, all its garbage is freed at once afterwards.
+collectgarbage()
+collectgarbage("stop")
+
 local started, fname_real = memprof.start(duration, fname_stub)
 assert(started == true, "Unable to start")
 
 payload()
+collectgarbage()
 
 local stopped = memprof.stop()
 assert(stopped == true, "Unable to stop")
+collectgarbage("restart")
 
 print(fname_real)